@@ -0,0 +1,55 @@
+﻿/**Prueba de la API: un lado quitado con EliminarLado() no vuelve en el
+ * snapshot que se guarda después.
+ * Uso: EliminarSnapshot s t x y SNAPSHOT < NETWORK
+ * Calcula el flujo maximal de 's' a 't', quita el lado 'xy', guarda el
+ * network en SNAPSHOT y lo vuelve a cargar, imprimiendo su flujo y su corte.*/
+#include <stdio.h>
+#include <stdlib.h>
+#include <inttypes.h>
+#include "../apifiles/API.h"
+
+int main(int argc, char *argv[]){
+    DovahkiinP dova = NULL; /*El network cargado de la entrada estándar*/
+    DovahkiinP snap = NULL; /*El network cargado del snapshot*/
+    u64 s, t, x, y;         /*Fuente, resumidero y extremos del lado a quitar*/
+    int result = 1;         /*Código de salida. Retorno*/
+    
+    if (argc == 6 && sscanf(argv[1], "%" SCNu64, &s) == 1 &&
+        sscanf(argv[2], "%" SCNu64, &t) == 1 &&
+        sscanf(argv[3], "%" SCNu64, &x) == 1 &&
+        sscanf(argv[4], "%" SCNu64, &y) == 1){
+        dova = NuevoDovahkiin();
+        CargarDesdeArchivo(dova, stdin);
+        FijarFuente(dova, s);
+        FijarResumidero(dova, t);
+        if (Prepararse(dova) == 1){
+            CalcularFlujoMaximal(dova);
+            if (!EliminarLado(dova, x, y))
+                printf("%s: El lado %s,%s no existe.\n", argv[0], argv[3],
+                       argv[4]);
+            else if (!GuardarSnapshot(dova, argv[5]))
+                printf("%s: Cannot write \"%s\".\n", argv[0], argv[5]);
+            else{
+                snap = NuevoDovahkiin();
+                if (!CargarSnapshot(snap, argv[5]))
+                    printf("%s: Cannot read \"%s\".\n", argv[0], argv[5]);
+                else{
+                    FijarFuente(snap, s);
+                    FijarResumidero(snap, t);
+                    if (Prepararse(snap) == 1){
+                        CalcularFlujoMaximal(snap);
+                        ImprimirFlujo(snap);
+                        ImprimirValorFlujo(snap);
+                        ImprimirCorte(snap);
+                        result = 0;
+                    }
+                }
+                DestruirDovahkiin(snap);
+            }
+        }
+        DestruirDovahkiin(dova);
+    }else
+        printf("Uso: %s s t x y SNAPSHOT < NETWORK\n", argv[0]);
+    
+    return result;
+}
@@ -31,4 +31,55 @@ echo -e "\nnet9" >> ./Results/RobustestLog
 ../dirmain/dinic -s 0 -t 0 -vf -c < ./Networks/Robustez/net9 >> ./Results/RobustestLog
 echo "net10"
 echo -e "\nnet10" >> ./Results/RobustestLog
-../dirmain/dinic -s 0 -t 1 -vf -c < ./Networks/Robustez/net10 >> ./Results/RobustestLog
\ No newline at end of file
+../dirmain/dinic -s 0 -t 1 -vf -c < ./Networks/Robustez/net10 >> ./Results/RobustestLog
+echo "net8 -e hl"
+echo -e "\nnet8 -e hl" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -vf -c -e hl < ./Networks/Robustez/net8 >> ./Results/RobustestLog
+echo "net8 -e fifo"
+echo -e "\nnet8 -e fifo" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -vf -c -e fifo < ./Networks/Robustez/net8 >> ./Results/RobustestLog
+echo "net8 -e par"
+echo -e "\nnet8 -e par" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -vf -c -e par -j 4 < ./Networks/Robustez/net8 >> ./Results/RobustestLog
+echo "net10 -j"
+echo -e "\nnet10 -j" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -vf -c -j 4 < ./Networks/Robustez/net10 >> ./Results/RobustestLog
+echo "net7 -P"
+echo -e "\nnet7 -P" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -vf -c -P < ./Networks/Robustez/net7 >> ./Results/RobustestLog
+echo "net8 -q"
+echo -e "\nnet8 -q" >> ./Results/RobustestLog
+../dirmain/dinic -q ./Networks/Robustez/pares8 -vf -c -i ./Networks/Robustez/net8 >> ./Results/RobustestLog
+echo "net8 -g"
+echo -e "\nnet8 -g" >> ./Results/RobustestLog
+../dirmain/dinic -g -i ./Networks/Robustez/net8 >> ./Results/RobustestLog
+echo "net8 -g -q"
+echo -e "\nnet8 -g -q" >> ./Results/RobustestLog
+../dirmain/dinic -g -q ./Networks/Robustez/pares8 -i ./Networks/Robustez/net8 >> ./Results/RobustestLog
+echo "net2 --save-snapshot"
+echo -e "\nnet2 --save-snapshot" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -vf -c --save-snapshot ./Results/net2.snap < ./Networks/Robustez/net2 >> ./Results/RobustestLog
+echo "net2 --snapshot"
+echo -e "\nnet2 --snapshot" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 -f -vf -c --snapshot ./Results/net2.snap >> ./Results/RobustestLog
+echo "net8 --snapshot -q"
+echo -e "\nnet8 --snapshot -q" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 --save-snapshot ./Results/net8.snap < ./Networks/Robustez/net8 > /dev/null
+../dirmain/dinic -q ./Networks/Robustez/pares8 -vf --snapshot ./Results/net8.snap >> ./Results/RobustestLog
+echo "net7 EliminarLado + --save-snapshot"
+echo -e "\nnet7 EliminarLado + --save-snapshot" >> ./Results/RobustestLog
+gcc -std=c99 -pthread -o ./Results/EliminarSnapshot ./EliminarSnapshot.c ../apifiles/*.c
+./Results/EliminarSnapshot 0 1 2 3 ./Results/net7.snap < ./Networks/Robustez/net7 >> ./Results/RobustestLog
+rm -f ./Results/net2.snap ./Results/net8.snap ./Results/net7.snap ./Results/EliminarSnapshot
+echo "net2 --dump-csv"
+echo -e "\nnet2 --dump-csv" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 --dump-csv ./Results/net2.csv < ./Networks/Robustez/net2 >> ./Results/RobustestLog
+cat ./Results/net2.csv >> ./Results/RobustestLog
+echo "net8 --dump-bin"
+echo -e "\nnet8 --dump-bin" >> ./Results/RobustestLog
+../dirmain/dinic -s 0 -t 1 --dump-bin ./Results/net8.bin < ./Networks/Robustez/net8 >> ./Results/RobustestLog
+od -An -v -tu8 ./Results/net8.bin >> ./Results/RobustestLog
+echo "net8 --dump-csv -q"
+echo -e "\nnet8 --dump-csv -q" >> ./Results/RobustestLog
+../dirmain/dinic -q ./Networks/Robustez/pares8 --dump-csv ./Results/net8.csv -i ./Networks/Robustez/net8 >> ./Results/RobustestLog
+rm -f ./Results/net2.csv ./Results/net8.bin ./Results/net8.csv
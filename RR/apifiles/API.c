@@ -1,21 +1,48 @@
-﻿#include <stdbool.h>
+#define _POSIX_C_SOURCE 200809L   /*open, fstat, mmap, posix_madvise*/
+
+#include <stdbool.h>
 #include <stdio.h>
 #include <stdlib.h>
 #include <assert.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
 #include "__uthash.h"
-#include "_stack.h"
-#include "_queue.h"
+#include "_arena.h"
 #include "__bstrlib.h"
 #include "_lexer.h"
 #include "nbrhd.h"
+#include "bfs.h"
+#include "preflow.h"
+#include "ghtree.h"
+#include "_writer.h"
 #include "API.h"
 #include "parser_lado.h"
 
 
 #define LVL_NIL -1      /**<Valor nulo de distancia para los nodos.*/
-#define DIR_NIL -1      /**<Valor nulo de dirección en el path para los nodos.*/    
+#define SNAP_MAGIC 0x31504e5341564f44ULL /**<"DOVASNP1": comienzo de un
+                                            snapshot, en el orden de la
+                                            máquina.*/
+#define SNAP_HEADER 3   /**<u64 del encabezado de un snapshot: SNAP_MAGIC,
+                            cantidad de nodos y de lados.*/
+#define DUMP_MAGIC 0x31574c4641564f44ULL /**<"DOVAFLW1" en little-endian:
+                                            comienzo de un volcado binario
+                                            de VolcarFlujo().*/
+/** Palabra de un bitset en la que está el bit de 'x' (un nodo o un arco).*/
+#define WORD(x) ((x) >> 6)
+/** Máscara del bit de 'x' en su palabra.*/
+#define BIT(x) ((u64) 1 << ((x) & 63))
+/** ¿El nodo 'x' está en el corte?*/
+#define IN_CUT(dova, x) (((dova)->inCut[WORD(x)] & BIT(x)) != 0)
+/** ¿El arco 'a' es de un lado quitado con EliminarLado()?*/
+#define IS_DEAD(dova, a) ((dova)->dead != NULL && \
+                          ((dova)->dead[WORD(a)] & BIT(a)) != 0)
 
 /* Macro: Flags de permisos y estados.*/
+#define PRUNE           0b00100000      /**<Se podan los nodos que no llegan
+                                            a t en el network de niveles.*/
 #define SINK_REACHED    0b00010000      /**<Se llego a t.*/
 #define MAXFLOW         0b00001000      /**<Es flujo maximal. Implica corte
                                             minimal.*/
@@ -27,31 +54,22 @@
 #define SET_FLAG(f) dova->flags |= f    /**<Activa(1) el bit de la flag f.*/
 #define UNSET_FLAG(f) dova->flags &= ~f /**<Desactiva(0) el bit de la flag f.*/
 #define CLEAR_FLAG() 0b00000001         /**<Inicializa todas las flags (reset).*/
-#define IS_SET_FLAG(f) (dova->flags & f) > 0 /**<¿El bit de la flag f es 1?.*/
-
+#define IS_SET_FLAG(f) ((dova->flags & (f)) > 0) /**<¿El bit de la flag f es 1?.*/
 
-/* Macro: Iterador sobre un path.*/
-/** Itera sobre los elementos de un path.*/
-#define PATH_ITER(path, x, y)                                               \
-    stack_resetViewer(path);                                               \
-    y = stack_nextItem(path);                                               \
-    x = stack_nextItem(path);                                               \
-    for(; (x)!=NULL; (y)=(x), (x)=stack_nextItem(path))
 
 /* Estructuras */
 /** Estructura de un netwrok con la información de los nodos.
- * Contiene la información de un nodo: su nombre, quiénes son sus vecinos, 
- * su nivel de distancia en la búsqueda de caminos aumentantes y la dirección
- * con la que fue agregado por su ancestro en el camino aumentante actual. 
- * Estos nodos están registrados en una tabla hash: La del network que 
- * conforman, y en el corte minimal si es que forman parte.
+ * Contiene la información de un nodo: su nombre, quiénes son sus vecinos y el
+ * id con el que se lo identifica en los algoritmos.
+ * Estos nodos están registrados en la tabla hash del network que conforman,
+ * que solo se usa para traducir nombres a ids al cargar lados y al fijar la
+ * fuente y el resumidero.
  */
 typedef struct NetworkSt{
     u64 name;                   /**<Hash key - nombre del nodo.*/
     Nbrhd nbrs;                 /**<Hash value - vecinos del nodo.*/
-    int lvl;                    /**<Nivel de distancia del nodo.*/
-    short int pDir;             /**<Dirección con su ancestro en el path.*/
-    UT_hash_handle hhNet,hhCut; /**<Hace esta estructura hashable.*/
+    u64 id;                     /**<Id del nodo: orden en que fue cargado.*/
+    UT_hash_handle hhNet;       /**<Hace esta estructura hashable.*/
 } Network;
 
 /** Estructura de un Dovahkiin con los datos que se necesitan almacenar para 
@@ -61,25 +79,80 @@ typedef struct NetworkSt{
  * es la fuente y cuál es resumidero. El último camino aumentante encontrado 
  * sin usar y la cantidad ya utilizados. También se almacenan las flags de 
  * estados que se necesiten en el transcurso de ejecución de DINIC.
+ * Los datos por nodo que usan los algoritmos (nivel, arco con su ancestro en
+ * el path, pertenencia al corte) están en arreglos indexados por
+ * el id del nodo, que existen mientras la CSR esté armada.
  */
 struct DovahkiinSt{
     Network *net;   /**<Network de los nodos para acceder a las aristas.*/
+    Arena arena;    /**<Arena de la que se piden los nodos y sus vecinos.*/
+    Network **nodes;/**<Nodos del network indexados por su id.*/
+    u64 n;          /**<Cantidad de nodos cargados.*/
+    u64 size;       /**<Capacidad del arreglo 'nodes'.*/
+    NbrhdCsr csr;   /**<Vecindades congeladas sobre las que corre Dinic.*/
+    Nbrhd *nbrs;    /**<Vecindades con las que se congeló la CSR.*/
+    int *lvl;       /**<Nivel de distancia de cada nodo.*/
+    u64 *pArc;      /**<Arco de cada nodo con su ancestro en el path.*/
+    u64 *cur;       /**<Arco actual de cada nodo en el DFS.*/
+    u64 *dfs;       /**<Pila de ids del DFS del flujo bloqueante.*/
+    u64 *frontier;  /**<Cola de ids del BFS de ActualizarDistancias().*/
+    u64 *inCut;     /**<Pertenencia al corte: bitset de un bit por nodo.*/
+    u64 *dead;      /**<Arcos FWD de los lados quitados con EliminarLado(), que
+                    siguen en la CSR: bitset de un bit por arco. NULL si no se
+                    quitó ninguno.*/
+    bool *live;     /**<El nodo está en un camino más corto de s a t.*/
+    Bfs bfs;        /**<BFS en paralelo. NULL si se trabaja con un solo hilo.*/
+    int engine;     /**<Motor de CalcularFlujoMaximal(). Ver FijarMotor().*/
     u64 flow;       /**<Valor del flujo del dova.*/
     u64 src;        /**<Nodo fijado como fuente (s).*/
     u64 snk;        /**<Nodo fijado como resumidero (t).*/
-    Network *cut;   /**<Corte minimal.*/
-    Stack path;     /**<Camino de nodos, de s a t.*/
+    u64 s;          /**<Id de la fuente, válido luego de Prepararse().*/
+    u64 t;          /**<Id del resumidero, válido luego de Prepararse().*/
+    u64 *cut;       /**<Corte minimal: ids de sus nodos en orden de BFS.*/
+    u64 cutSize;    /**<Cantidad de nodos en el corte.*/
+    u64 *path;      /**<Arcos del camino aumentante, de s a t.*/
+    u64 *pathMin;   /**<pathMin[k]: mínimo residuo de los primeros k arcos del
+                    camino. pathMin[0] es u64_MAX.*/
+    u64 pathLen;    /**<Cantidad de arcos del camino aumentante.*/
     u64 pCounter;   /**<Contador para la cantidad de caminos.*/
     int flags;      /**<Flags de estado, explicados en la sección define.*/
+    u64 *snap;      /**<Snapshot mapeado en memoria, sobre el que está la CSR.
+                    NULL si el network se cargó de a lados.*/
+    size_t snapLen; /**<Tamaño del snapshot mapeado.*/
+    GhTree gh;      /**<Árbol de Gomory-Hu del network. NULL si no se calculó
+                    o el network cambió.*/
+    Writer out;     /**<Salida estándar con buffer propio, para lo que se
+                    imprime en cantidad (flujo, corte y caminos).*/
 };
 
 
 /* Funciones estáticas */
-static u64 get_pathFlow(DovahkiinP dova);
-static Network *network_create(u64 n);
-static void network_destroy(Network *net);
-static Network *network_nextNode(Network * net, Network *x, short int *dir);
-static void set_lvlNbrs(DovahkiinP dova, Network *x, Queue q);
+static Network *network_create(Arena arena, u64 n, u64 id);
+static Network *network_add(DovahkiinP dova, u64 name);
+static Network *network_find(DovahkiinP dova, u64 name);
+static void network_index(DovahkiinP dova);
+static void dova_addEdge(DovahkiinP dova, u64 x, u64 y, u64 c);
+static u64 dova_scanEdges(DovahkiinP dova, LadoScanner sc);
+static bool network_nextArc(DovahkiinP dova, u64 x, u64 *arc);
+static bool network_findArc(DovahkiinP dova, u64 x, u64 y, u64 *arc);
+static void set_lvlNbrs(DovahkiinP dova, u64 x, u64 *tail);
+static void cut_clear(DovahkiinP dova);
+static void cut_fill(DovahkiinP dova, u64 size);
+static u64 cut_scan(DovahkiinP dova, u64 *edges, u64 *count);
+static void lvl_reset(DovahkiinP dova);
+static void lvl_prune(DovahkiinP dova);
+static void dova_alloc(DovahkiinP dova);
+static void dova_freeze(DovahkiinP dova);
+static void dova_thaw(DovahkiinP dova);
+static void dova_unpack(DovahkiinP dova);
+static void dova_setCap(DovahkiinP dova, u64 x, u64 y, u64 arc, u64 c);
+static u64 repair_excess(DovahkiinP dova, u64 x, u64 y, u64 e);
+static void repair_deficit(DovahkiinP dova, u64 y, u64 e);
+static u64 source_outflow(DovahkiinP dova);
+static void gh_clear(DovahkiinP dova);
+static void out_lado(DovahkiinP dova, u64 x, u64 y, u64 v);
+static u64 dump_edges(DovahkiinP dova, Writer W, int formato);
+static void dump_edge(Writer W, int formato, u64 x, u64 y, u64 f);
 
 /** Creador de un nuevo DovahkiinP.
  * \return un DovahkiinP vacío.
@@ -92,13 +165,38 @@ DovahkiinP NuevoDovahkiin(void){
     assert(dova!=NULL);
     /*Valores iniciales de un dova vacío*/
     dova->net = NULL;
+    dova->arena = arena_create();
+    dova->nodes = NULL;
+    dova->n = 0;
+    dova->size = 0;
+    dova->csr = NULL;
+    dova->nbrs = NULL;
+    dova->lvl = NULL;
+    dova->pArc = NULL;
+    dova->cur = NULL;
+    dova->dfs = NULL;
+    dova->frontier = NULL;
+    dova->path = NULL;
+    dova->pathMin = NULL;
+    dova->inCut = NULL;
+    dova->dead = NULL;
+    dova->live = NULL;
+    dova->bfs = NULL;
+    dova->engine = MOTOR_DINIC;
     dova->flow = 0;
     dova->src = 0;
     dova->snk = 0;
+    dova->s = 0;
+    dova->t = 0;
     dova->cut = NULL;
-    dova->path = NULL;
+    dova->cutSize = 0;
+    dova->pathLen = 0;
     dova->flags = CLEAR_FLAG();
     dova->pCounter = 0; 
+    dova->snap = NULL;
+    dova->snapLen = 0;
+    dova->gh = NULL;
+    dova->out = writer_createFile(stdout);
     return dova;
 }
 
@@ -109,24 +207,43 @@ DovahkiinP NuevoDovahkiin(void){
  * en la implementación no surgen casos en lo que esto pueda suceder.
  */
 int DestruirDovahkiin(DovahkiinP dova){
-    Network *node = NULL;   /*El i-esimo nodo en la hash del network*/
-    Network *ref = NULL;    /*Lo necesita HASH_ITER para no perder referencias*/
+    u64 i;                  /*Id del nodo actual*/
+    
     assert(dova!=NULL);
-    /*Primero hay que destruir las entradas de la hash del corte.
-    Si se destruyen primero los nodos entonces pierdo referencias*/
-    if (dova->cut != NULL)
-        HASH_CLEAR(hhCut, dova->cut);
-    /*En este punto ya se puede destruir el network y todos los nodos.
-    Esto también libera la hash del corte.*/
-    if (dova->net != NULL)
-        HASH_ITER(hhNet, dova->net, node, ref){
-            /*Elimina la referencia en la hash del network*/
-            HASH_DELETE(hhNet, dova->net, node);
-            network_destroy(node);
-        }
-    /*Se destruye cualquier path almacenado.*/
-    if (dova->path != NULL)
-        stack_destroy(dova->path, NULL);
+    /*Se destruye la CSR con los datos por nodo de los algoritmos*/
+    if (dova->csr != NULL){
+        nbrhd_csrDestroy(dova->csr);
+        free(dova->nbrs);
+        free(dova->lvl);
+        free(dova->pArc);
+        free(dova->cur);
+        free(dova->dfs);
+        free(dova->frontier);
+        free(dova->path);
+        free(dova->pathMin);
+        free(dova->inCut);
+        free(dova->dead);
+        free(dova->live);
+        free(dova->cut);
+    }
+    /*En este punto ya se puede destruir el network y todos los nodos. Solo
+     las tablas hash se liberan aparte, el resto se va con la arena. Los nodos
+     de un snapshot no tienen vecindades, sus lados están en el archivo.*/
+    if (dova->snap != NULL)
+        munmap(dova->snap, dova->snapLen);
+    else{
+        for(i = 0; i < dova->n; i++)
+            nbrhd_destroy(dova->nodes[i]->nbrs);
+    }
+    HASH_CLEAR(hhNet, dova->net);
+    free(dova->nodes);
+    arena_destroy(dova->arena);
+    if (dova->gh != NULL)
+        ghtree_destroy(dova->gh);
+    /*Se terminan los hilos del BFS en paralelo, si los hay.*/
+    if (dova->bfs != NULL)
+        bfs_destroy(dova->bfs);
+    writer_destroy(dova->out);
     free(dova);
     dova = NULL;
     return 1;
@@ -154,6 +271,62 @@ void FijarResumidero(DovahkiinP dova, u64 t){
     SET_FLAG(SINK);
 }
 
+/** Establece la cantidad de hilos con los que se arman los niveles.
+ * Con al menos un hilo, ActualizarDistancias() usa un BFS sincronizado por
+ * niveles que reparte cada nivel entre los hilos y, cuando la frontera es
+ * grande, lo arma de abajo hacia arriba. Los niveles que se obtienen son los
+ * mismos que con el BFS de siempre, por lo que el flujo, los caminos y el
+ * corte no cambian.
+ * \param dova    El dova en el que se trabaja.
+ * \param threads Cantidad de hilos. 0 para volver al BFS de siempre.
+ * \pre \p dova debe ser un DovahkiinP no nulo.
+ */
+void FijarHilos(DovahkiinP dova, unsigned int threads){
+    assert(dova != NULL);
+    if (dova->bfs != NULL){
+        bfs_destroy(dova->bfs);
+        dova->bfs = NULL;
+    }
+    if (threads > 0)
+        dova->bfs = bfs_create(threads);
+}
+
+/** Activa o desactiva la poda del network de niveles.
+ * Con la poda activa, cada vez que ActualizarDistancias() alcanza 't' se hace
+ * un BFS hacia atrás desde 't' y se anula el nivel de los nodos que no están
+ * en ningún camino más corto de 's' a 't'. El DFS ya no entra en ellos, y los
+ * caminos que encuentra son los mismos.
+ * \param dova  El dova en el que se trabaja.
+ * \param on    1 para activar la poda, 0 para desactivarla.
+ * \pre \p dova debe ser un DovahkiinP no nulo.
+ */
+void FijarPoda(DovahkiinP dova, int on){
+    assert(dova != NULL);
+    if (on)
+        SET_FLAG(PRUNE);
+    else
+        UNSET_FLAG(PRUNE);
+}
+
+/** Establece el motor con el que CalcularFlujoMaximal() calcula el flujo.
+ * Con MOTOR_DINIC (el de siempre) se alternan niveles y flujos bloqueantes.
+ * Con MOTOR_HL o MOTOR_FIFO se usa push-relabel, con global relabel y gap,
+ * que suele ser más rápido en networks densos o con mucho fan-in. Se obtiene
+ * el mismo valor de flujo, pero el flujo de cada lado puede ser otro.
+ * Con MOTOR_PAR se usa push-relabel en paralelo, con los hilos fijados con
+ * FijarHilos() (uno si no se fijaron). El flujo de cada lado puede cambiar de
+ * una corrida a otra.
+ * \param dova   El dova en el que se trabaja.
+ * \param motor  MOTOR_DINIC, MOTOR_HL, MOTOR_FIFO o MOTOR_PAR.
+ * \pre \p dova debe ser un DovahkiinP no nulo.
+ */
+void FijarMotor(DovahkiinP dova, int motor){
+    assert(dova != NULL);
+    assert(motor == MOTOR_DINIC || motor == MOTOR_HL || motor == MOTOR_FIFO ||
+           motor == MOTOR_PAR);
+    dova->engine = motor;
+}
+
 /** Imprime por la salida estándar el nombre del nodo que es fuente.
  * Imprime por pantalla:\n
  * Fuente: s \n
@@ -244,43 +417,450 @@ Lado LeerUnLado(void){
  *          0 caso contrario.
  */
 int CargarUnLado(DovahkiinP dova, Lado edge){
-    Network *x = NULL;  /*Nodo 'x'*/
-    Network *y = NULL;  /*Nodo 'y'*/
-    u64 xName, yName;   /*Nombres del nodo 'x' e 'y'*/
     int result = 0;     /*Retorno*/
     
     assert(dova != NULL);
     
     if (edge != LadoNulo){
-        xName = lado_getX(edge);
-        /*Cargo el nodo 'x', si todavía no existe en el network*/
-        HASH_FIND(hhNet, dova->net, &(xName), sizeof(xName), x);
-        if (x == NULL){
-            x = network_create(xName);
-            HASH_ADD(hhNet, dova->net, name, sizeof(dova->net->name), x);
-        }
+        dova_addEdge(dova, lado_getX(edge), lado_getY(edge), lado_getCap(edge));
+        result = 1;
+        lado_destroy(edge); /*Destruyo el lado, ya no nos sirve*/
+    }
+    
+    return result;
+}
+
+/** Carga en un DovahkiinP todos los lados de un archivo.
+ * Es equivalente a llamar a LeerUnLado() y CargarUnLado() hasta que no se 
+ * pueda cargar un lado: se aceptan las mismas lineas y se termina en la 
+ * primera que no es valida (o en el fin de archivo). Pero el archivo se lee de
+ * a bloques y se parsea sin crear un Lexer ni un Lado por linea.
+ * \note El archivo se lee por adelantado, por lo que puede quedar posicionado
+ * más allá de la linea en la que se terminó la carga.
+ * \param dova  El dova en el que se trabaja.
+ * \param f     El archivo abierto del que se leen los lados.
+ * \pre \p dova Debe ser un DovahkiinP no nulo y \p f un archivo abierto.
+ * \return  Cantidad de lados cargados.
+ */
+u64 CargarDesdeArchivo(DovahkiinP dova, FILE *f){
+    LadoScanner sc;     /*Lector en bloque del archivo*/
+    u64 count = 0;      /*Cantidad de lados cargados. Retorno*/
+    
+    assert(dova != NULL && f != NULL);
+    
+    sc = parser_scannerNew(f);
+    count = dova_scanEdges(dova, sc);
+    parser_scannerDestroy(sc);
+    return count;
+}
+
+/** Carga en un DovahkiinP todos los lados del archivo de ruta \p path.
+ * Se aceptan las mismas lineas que en CargarDesdeArchivo(). Si el archivo es
+ * regular se mapea en memoria y se parsea directamente desde ahí, sin copiarlo
+ * a un buffer; si no (una tubería, una terminal) se lee de a bloques.
+ * \param dova  El dova en el que se trabaja.
+ * \param path  Ruta del archivo del que se leen los lados.
+ * \pre \p dova Debe ser un DovahkiinP no nulo y \p path no nulo.
+ * \return  1 si se pudo leer el archivo.\n
+ *          0 caso contrario.
+ */
+int CargarDesdeRuta(DovahkiinP dova, const char *path){
+    LadoScanner sc;     /*Lector de los lados del archivo*/
+    struct stat st;     /*Datos del archivo*/
+    FILE *f = NULL;     /*El archivo, si no se puede mapear*/
+    void *data;         /*El archivo mapeado en memoria*/
+    size_t len;         /*Tamaño del archivo mapeado*/
+    int fd;             /*Descriptor del archivo*/
+    int result = 0;     /*Retorno*/
+    
+    assert(dova != NULL && path != NULL);
+    
+    fd = open(path, O_RDONLY);
+    if (fd != -1 && fstat(fd, &st) == 0){
+        len = (size_t) st.st_size;
+        data = MAP_FAILED;
+        if (S_ISREG(st.st_mode) && len > 0)
+            data = mmap(NULL, len, PROT_READ, MAP_PRIVATE, fd, 0);
         
-        yName = lado_getY(edge);
-        /*Cargo el nodo 'y', si todavía no existe en el network*/
-        HASH_FIND(hhNet, dova->net, &(yName), sizeof(yName), y);
-        if (y == NULL){
-            y = network_create(yName);
-            HASH_ADD(hhNet, dova->net, name, sizeof(dova->net->name), y);
+        if (data != MAP_FAILED){
+            posix_madvise(data, len, POSIX_MADV_SEQUENTIAL);
+            sc = parser_scannerNewMem((const char *) data, len);
+            dova_scanEdges(dova, sc);
+            parser_scannerDestroy(sc);
+            munmap(data, len);
+            result = 1;
+        }else{
+            f = fdopen(fd, "r");
+            if (f != NULL){
+                CargarDesdeArchivo(dova, f);
+                fclose(f);      /*Cierra también fd*/
+                fd = -1;
+                result = 1;
+            }
         }
-        /*Se establecen como vecinos. Arista 'xy'*/
-        nbrhd_addEdge(x->nbrs, y->nbrs, edge);
+    }
+    if (fd != -1)
+        close(fd);
+    
+    return result;
+}
+
+/** Guarda el network de un DovahkiinP en un snapshot binario, que luego se
+ * carga con CargarSnapshot() sin volver a parsear los lados.
+ * El snapshot tiene un encabezado (SNAP_MAGIC, cantidad de nodos y de lados),
+ * los nombres de los nodos por id y los arreglos de la CSR con las
+ * capacidades, todo en u64 en el orden de la máquina. No guarda el flujo.
+ * \note Si la CSR no estaba armada, se arma aquí, como en Prepararse().
+ * \note Los lados quitados con EliminarLado() siguen en la CSR, marcados en
+ * 'dead', y no se guardan.
+ * \param dova  El dova en el que se trabaja.
+ * \param path  Ruta del archivo a escribir.
+ * \pre \p dova Debe ser un DovahkiinP no nulo y \p path no nulo.
+ * \return  1 si se pudo escribir el snapshot.\n
+ *          0 caso contrario.
+ */
+int GuardarSnapshot(DovahkiinP dova, const char *path){
+    u64 header[SNAP_HEADER];    /*Encabezado del snapshot*/
+    FILE *f = NULL;             /*El archivo del snapshot*/
+    bool ok = false;            /*No falló ninguna escritura*/
+    u64 i;                      /*Id del nodo actual*/
+    u64 a;                      /*Arco actual*/
+    u64 m;                      /*Cantidad de lados que se guardan*/
+    
+    assert(dova != NULL && path != NULL);
+    
+    if (dova->csr == NULL)
+        dova_freeze(dova);
+    m = nbrhd_csrEdges(dova->csr);
+    for(a = 0; dova->dead != NULL && a < 2*nbrhd_csrEdges(dova->csr); a++){
+        if (IS_DEAD(dova, a))
+            m--;
+    }
+    f = fopen(path, "wb");
+    if (f != NULL){
+        header[0] = SNAP_MAGIC;
+        header[1] = dova->n;
+        header[2] = m;
+        ok = fwrite(header, sizeof(u64), SNAP_HEADER, f) == SNAP_HEADER;
+        for(i = 0; i < dova->n && ok; i++)
+            ok = fwrite(&dova->nodes[i]->name, sizeof(u64), 1, f) == 1;
+        ok = ok && nbrhd_csrWrite(dova->csr, dova->dead, f);
+        ok = fclose(f) == 0 && ok;
+    }
+    return ok ? 1 : 0;
+}
+
+/** Carga en un DovahkiinP vacío el network de un snapshot escrito con
+ * GuardarSnapshot().
+ * El archivo se mapea en memoria y la CSR trabaja directamente sobre él (en
+ * una copia privada, el archivo no cambia), sin parsear ni armar las tablas
+ * hash de los nodos y sus vecinos. Solo se arma el arreglo de nodos por id.
+ * Queda lista para Prepararse() y los algoritmos, con flujo nulo.
+ * \note Si luego se carga un lado, los del snapshot se pasan primero a las
+ * vecindades, como si se hubieran cargado de a uno.
+ * \param dova  El dova en el que se trabaja.
+ * \param path  Ruta del snapshot.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, sin lados cargados, y \p path
+ *      no nulo.
+ * \return  1 si se pudo cargar el snapshot.\n
+ *          0 si no se pudo leer o no es un snapshot.
+ */
+int CargarSnapshot(DovahkiinP dova, const char *path){
+    struct stat st;         /*Datos del archivo*/
+    u64 *data = NULL;       /*El archivo mapeado en memoria*/
+    size_t len = 0;         /*Tamaño del archivo mapeado*/
+    Network *block = NULL;  /*Los nodos, contiguos*/
+    u64 n = 0, m = 0;       /*Cantidad de nodos y de lados*/
+    u64 i;                  /*Id del nodo actual*/
+    int fd;                 /*Descriptor del archivo*/
+    int result = 0;         /*Retorno*/
+    
+    assert(dova != NULL && path != NULL);
+    assert(dova->n == 0 && dova->snap == NULL);
+    
+    fd = open(path, O_RDONLY);
+    if (fd != -1 && fstat(fd, &st) == 0 && S_ISREG(st.st_mode) &&
+        (size_t) st.st_size >= SNAP_HEADER * sizeof(u64)){
+        len = (size_t) st.st_size;
+        data = (u64*) mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE, 
+                           fd, 0);
+        if (data != MAP_FAILED){
+            n = data[1];
+            m = data[2];
+            /*El tamaño tiene que ser el que indica el encabezado, y los
+             arreglos los de una CSR, o la CSR se saldría de ellos*/
+            if (data[0] == SNAP_MAGIC && n < len && m < len &&
+                len == (SNAP_HEADER + n + nbrhd_csrWords(n, m)) * sizeof(u64) &&
+                nbrhd_csrValid(data + SNAP_HEADER + n, n, m))
+                result = 1;
+            else
+                munmap(data, len);
+        }
+    }
+    if (fd != -1)
+        close(fd);
+    
+    if (result){
+        /*Los nodos se piden juntos y se apuntan desde el arreglo por id*/
+        block = (Network*) arena_alloc(dova->arena, (n + 1) * sizeof(Network));
+        dova->nodes = (Network**) malloc((n + 1) * sizeof(Network*));
+        assert(dova->nodes != NULL);
+        for(i = 0; i < n; i++){
+            block[i].name = data[SNAP_HEADER + i];
+            block[i].nbrs = NULL;
+            block[i].id = i;
+            dova->nodes[i] = &block[i];
+        }
+        dova->n = n;
+        dova->size = n + 1;
+        dova->snap = data;
+        dova->snapLen = len;
+        dova_alloc(dova);
+        dova->csr = nbrhd_csrMap(data + SNAP_HEADER + n, n, m);
+    }
+    return result;
+}
+
+/** Aumenta en \p c la capacidad del lado 'xy', o lo agrega si no existe, sin
+ * perder el flujo que ya se calculó.
+ * El flujo sigue siendo válido, pero puede dejar de ser maximal: la próxima
+ * vuelta de ActualizarDistancias() (o CalcularFlujoMaximal()) sigue desde él,
+ * y si el cambio es chico termina en pocas fases.
+ * Si el lado ya existe y la CSR está armada, solo se suma el aumento al
+ * residuo de su arco FWD. Si no, se carga como con CargarUnLado() y, si la CSR
+ * estaba armada, se vuelve a armar con el flujo actual, así que no hace falta
+ * volver a llamar a Prepararse().
+ * \param dova  El dova en el que se trabaja.
+ * \param x     Nombre del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \param c     Capacidad que se agrega al lado.
+ * \pre \p dova Debe ser un DovahkiinP no nulo.
+ */
+void AumentarCapacidad(DovahkiinP dova, u64 x, u64 y, u64 c){
+    Network *xNode = NULL;  /*Nodo 'x'*/
+    Network *yNode = NULL;  /*Nodo 'y'*/
+    u64 arc;                /*Arco FWD del lado 'xy'*/
+    bool frozen;            /*La CSR estaba armada*/
+    
+    assert(dova != NULL);
+    
+    xNode = network_find(dova, x);
+    yNode = network_find(dova, y);
+    /*Un lado que se quitó con EliminarLado() sigue en la CSR, pero se vuelve
+     a agregar como uno nuevo*/
+    if (dova->csr != NULL && xNode != NULL && yNode != NULL &&
+        (dova->snap != NULL || nbrhd_hasEdge(xNode->nbrs, y)) &&
+        network_findArc(dova, xNode->id, yNode->id, &arc)){
+        nbrhd_arcAddCap(dova->csr, arc, c);
+        gh_clear(dova);
+        /*Los lados de un snapshot solo están en la CSR*/
+        if (dova->snap == NULL)
+            nbrhd_addEdge(xNode->nbrs, yNode->nbrs, x, y, c);
+    }else{
+        frozen = dova->csr != NULL;
+        dova_addEdge(dova, x, y, c);
+        if (frozen)
+            dova_freeze(dova);
+    }
+    /*El corte y un camino encontrado antes quedaron sin sentido*/
+    UNSET_FLAG(MAXFLOW);
+    SET_FLAG(PATHUSED);
+}
+
+/** Baja en \p c la capacidad del lado 'xy' (hasta 0), sin perder el flujo
+ * que ya se calculó.
+ * Si el flujo del lado no entra en la nueva capacidad, se le quita lo que
+ * sobra y se repara el flujo cerca del lado: el exceso que queda en 'x' se
+ * manda por caminos residuales hacia 'y' (y el valor no cambia), o de vuelta
+ * a 's' o hacia 't'; lo que 'y' no recibió se trae por caminos residuales
+ * desde 't' o desde 's'. Luego, como en AumentarCapacidad(), la próxima
+ * vuelta de ActualizarDistancias() (o CalcularFlujoMaximal()) reoptimiza desde
+ * el flujo reparado.
+ * \param dova  El dova en el que se trabaja.
+ * \param x     Nombre del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \param c     Capacidad que se le quita al lado.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, preparado con Prepararse().
+ * \return  1 si el lado existe y se bajó su capacidad.\n
+ *          0 si el lado no existe.
+ */
+int DisminuirCapacidad(DovahkiinP dova, u64 x, u64 y, u64 c){
+    Network *xNode = NULL;  /*Nodo 'x'*/
+    Network *yNode = NULL;  /*Nodo 'y'*/
+    u64 arc;                /*Arco FWD del lado 'xy'*/
+    u64 cap;                /*Capacidad actual del lado*/
+    int result = 0;         /*Se encontró el lado. Retorno*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    xNode = network_find(dova, x);
+    yNode = network_find(dova, y);
+    /*Un lado que se quitó sigue en la CSR, pero no en las vecindades*/
+    if (xNode != NULL && yNode != NULL &&
+        (dova->snap != NULL || nbrhd_hasEdge(xNode->nbrs, y)) &&
+        network_findArc(dova, xNode->id, yNode->id, &arc)){
+        cap = nbrhd_arcCap(dova->csr, arc);
+        dova_setCap(dova, xNode->id, yNode->id, arc, cap > c ? cap - c : 0);
         result = 1;
-        lado_destroy(edge); /*Destruyo el lado, ya no nos sirve*/
     }
+    return result;
+}
+
+/** Quita el lado 'xy' del network, sin perder el flujo que ya se calculó.
+ * El flujo del lado se repara como en DisminuirCapacidad() con toda su
+ * capacidad, y el lado deja de aparecer en ImprimirFlujo(). Su arco queda en la
+ * CSR sin residuo en ninguna dirección, así que los algoritmos no lo usan y no
+ * hace falta volver a armarla. Si el network se cargó de un snapshot, antes se
+ * pasa a las vecindades (una sola vez).
+ * \param dova  El dova en el que se trabaja.
+ * \param x     Nombre del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, preparado con Prepararse().
+ * \return  1 si el lado existía y se quitó.\n
+ *          0 si el lado no existe.
+ */
+int EliminarLado(DovahkiinP dova, u64 x, u64 y){
+    Network *xNode = NULL;  /*Nodo 'x'*/
+    Network *yNode = NULL;  /*Nodo 'y'*/
+    u64 arc;                /*Arco FWD del lado 'xy'*/
+    int result = 0;         /*Se encontró el lado. Retorno*/
     
+    assert(dova != NULL && dova->csr != NULL);
+    
+    xNode = network_find(dova, x);
+    yNode = network_find(dova, y);
+    if (xNode != NULL && yNode != NULL &&
+        (dova->snap != NULL || nbrhd_hasEdge(xNode->nbrs, y)) &&
+        network_findArc(dova, xNode->id, yNode->id, &arc)){
+        /*Los lados de un snapshot solo están en la CSR*/
+        if (dova->snap != NULL){
+            dova_unpack(dova);
+            dova_freeze(dova);
+            network_findArc(dova, xNode->id, yNode->id, &arc);
+        }
+        dova_setCap(dova, xNode->id, yNode->id, arc, 0);
+        nbrhd_removeEdge(xNode->nbrs, yNode->nbrs, x, y);
+        /*El arco queda en la CSR, marcado para no confundirlo con un lado de
+         capacidad 0*/
+        if (dova->dead == NULL){
+            dova->dead = (u64*) calloc(WORD(2*nbrhd_csrEdges(dova->csr)) + 1,
+                                       sizeof(u64));
+            assert(dova->dead != NULL);
+        }
+        dova->dead[WORD(arc)] |= BIT(arc);
+        result = 1;
+    }
     return result;
 }
 
+/** Anula el flujo de todos los lados, para volver a calcular sobre el mismo
+ * network (por ejemplo con otra fuente o resumidero) sin volver a cargarlo.
+ * Es una sola pasada por los lados: sobre la CSR si está armada, que se
+ * conserva, o sobre las vecindades si no. El flujo deja de ser maximal y
+ * se descartan el corte y el camino que se hubiera encontrado.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova Debe ser un DovahkiinP no nulo.
+ */
+void ResetearFlujo(DovahkiinP dova){
+    u64 i;  /*Id del nodo actual*/
+    
+    assert(dova != NULL);
+    
+    if (dova->csr != NULL){
+        nbrhd_csrReset(dova->csr);
+        cut_clear(dova);
+    }else{
+        for(i = 0; i < dova->n; i++)
+            nbrhd_resetFlow(dova->nodes[i]->nbrs);
+    }
+    dova->flow = 0;
+    dova->pCounter = 0;
+    UNSET_FLAG(MAXFLOW);
+    SET_FLAG(PATHUSED);
+}
+
+/** Calcula el árbol de Gomory-Hu del network, con el que se conoce el corte
+ * minimal entre cualquier par de nodos (ver CorteMinimoEntre() e
+ * ImprimirArbolGomoryHu()).
+ * El network se toma como no dirigido: un lado 'xy' de capacidad c permite
+ * enviar hasta c en cualquiera de los dos sentidos. Se calculan n-1 flujos
+ * maximales con push-relabel (método de Gusfield), tantos a la vez como hilos
+ * se fijaron con FijarHilos() (uno si no se fijaron), cada uno sobre su propia
+ * copia de los residuos. El flujo del dova no cambia.
+ * El árbol vale hasta que cambie el network; si no existía, se arma la CSR.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova Debe ser un DovahkiinP no nulo.
+ */
+void CalcularArbolGomoryHu(DovahkiinP dova){
+    assert(dova != NULL);
+    
+    if (dova->csr == NULL)
+        dova_freeze(dova);
+    gh_clear(dova);
+    dova->gh = ghtree_build(dova->csr, dova->n, 
+                            dova->bfs != NULL ? bfs_threads(dova->bfs) : 1);
+}
+
+/** Capacidad del corte minimal entre los nodos 'x' e 'y' del network tomado
+ * como no dirigido, según el árbol de Gomory-Hu. Solo se recorre el camino
+ * entre ellos en el árbol.
+ * \param dova  El dova en el que se trabaja.
+ * \param x     Nombre del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \param cut   Donde se almacena la capacidad del corte.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, con el árbol calculado por
+ *      CalcularArbolGomoryHu(). \p cut no es nulo.
+ * \return  1 si ambos nodos existen, son distintos, y se almacenó el corte.\n
+ *          0 caso contrario.
+ */
+int CorteMinimoEntre(DovahkiinP dova, u64 x, u64 y, u64 *cut){
+    Network *xNode = NULL;  /*Nodo 'x'*/
+    Network *yNode = NULL;  /*Nodo 'y'*/
+    int result = 0;         /*Se calculó el corte. Retorno*/
+    
+    assert(dova != NULL && dova->gh != NULL && cut != NULL);
+    
+    xNode = network_find(dova, x);
+    yNode = network_find(dova, y);
+    if (xNode != NULL && yNode != NULL && xNode != yNode){
+        *cut = ghtree_minCut(dova->gh, xNode->id, yNode->id);
+        result = 1;
+    }
+    return result;
+}
+
+/** Imprime por Estandar Output el árbol de Gomory-Hu.
+ * Imprime con el formato: \n
+ * \verbatim Arbol de Gomory-Hu:
+   Lado x_1,y_2: <CorteMinimal>
+   \endverbatim
+ * Con un lado por nodo, salvo la raíz, hacia su padre en el árbol, en el
+ * orden en que se cargaron los nodos.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, con el árbol calculado por
+ *      CalcularArbolGomoryHu().
+ */
+void ImprimirArbolGomoryHu(DovahkiinP dova){
+    u64 i;  /*Id del nodo actual*/
+    
+    assert(dova != NULL && dova->gh != NULL);
+    
+    writer_str(dova->out, "Arbol de Gomory-Hu:\n");
+    for(i = 1; i < dova->n; i++)
+        out_lado(dova, dova->nodes[i]->name,
+                 dova->nodes[ghtree_parent(dova->gh, i)]->name,
+                 ghtree_weight(dova->gh, i));
+    writer_char(dova->out, '\n');
+    writer_flush(dova->out);
+}
+
 /** Preprocesa el DovahkiinP para empezar a buscar caminos aumentantes. 
  * Aquí se debe chequear y preparar todo lo que sea necesario para comenzar
  * a buscar caminos aumentantes. \n
- * Por el momento solo hace falta chequear que estén seteados s y t, 
- * y que estos nodos existen en el network.
+ * Se chequea que estén seteados s y t, y que estos nodos existen en el
+ * network. Si es así, se congelan las vecindades en la CSR sobre la que
+ * trabajan ActualizarDistancias(), BusquedaCaminoAumentante() y
+ * AumentarFlujo().
  * \param dova  El dova en el que se trabaja.
  * \pre \p dova Debe ser un DovahkiinP no nulo.
  * \return  1 si los preparativos fueron exitosos.\n
@@ -296,11 +876,17 @@ int Prepararse(DovahkiinP dova){
      en el network*/
     if(IS_SET_FLAG(SINK) && IS_SET_FLAG(SOURCE)){
         /*Se buscan en el network*/
-        HASH_FIND(hhNet, dova->net, &(dova->src), sizeof(dova->src), s);
-        HASH_FIND(hhNet, dova->net, &(dova->snk), sizeof(dova->snk), t);
-        if (s != NULL && t != NULL) 
+        s = network_find(dova, dova->src);
+        t = network_find(dova, dova->snk);
+        if (s != NULL && t != NULL){
             status = 1; /*Ambos existen, todo OK*/
+            dova->s = s->id;
+            dova->t = t->id;
+        }
     }
+    /*Se arma la CSR, si no existe una que represente al network actual*/
+    if (status && dova->csr == NULL)
+        dova_freeze(dova);
     return status;
 }
 
@@ -310,56 +896,61 @@ int Prepararse(DovahkiinP dova){
  * nodo resumidero 't'. \n
  * Si se alcanza 't' entonces implica un camino aumentante. Caso contrario, el
  * flujo actual es maximal y los nodos que fueron actualizados conforman el
- * corte minimal.
+ * corte minimal, que se arma solo entonces a partir de la cola del BFS.
+ * \note Si se fijaron hilos con FijarHilos(), los niveles se arman con el BFS
+ * por niveles (en paralelo y de abajo hacia arriba si conviene). Los niveles
+ * son los mismos; sólo en la última búsqueda, la que no alcanza 't', se repite
+ * el BFS de siempre para armar el corte.
+ * \note Si se activó la poda con FijarPoda(), al alcanzar 't' se anula el
+ * nivel de los nodos que no están en ningún camino más corto de 's' a 't'.
  * \param dova  El dova en el que se trabaja.
  * \pre \p dova Debe ser un DovahkiinP no nulo.
  * \return  1 si existe un camino aumentante entre 's' y 't'. \n
  *          0 caso contrario.
  */
 int ActualizarDistancias(DovahkiinP dova){
-    Queue q, qNext;         /*Colas para el manejo de los niveles. 
-                            q = nodos del nivel actual; qNext = del siguiente*/
-    Network *node = NULL;   /*Nodo actual de 'q' en el cual se itera*/
-    Network *k = NULL;      /*Iterador para reseteo de las distancias*/
+    u64 head = 0, tail = 0; /*Extremos de la cola 'frontier'. Los niveles
+                            quedan en orden, uno detrás del otro*/
+    u64 x;                  /*Nodo actual de la cola en el cual se itera*/
 
     assert(dova != NULL);
+    assert(dova->csr != NULL);
     
     /*Preparación de las cosas que voy a usar*/
     UNSET_FLAG(SINK_REACHED);
-    HASH_CLEAR(hhCut, dova->cut);
-    q = queue_create();
-    qNext = queue_create();
-    
-    /* Reset de distancias por llamadas anteriores*/
-    for(k = dova->net; k != NULL; k = k->hhNet.next){
-        k->lvl = LVL_NIL;
-    }    
-    /*La fuente es nivel 0*/
-    HASH_FIND(hhNet, dova->net, &(dova->src), sizeof(dova->src), node);
-    assert(node != NULL);
-    node->lvl = 0;
-    queue_enqueue(q, node);
-
-    /*Actualización de distancias por BFS */
-    while(!queue_isEmpty(q) && !IS_SET_FLAG(SINK_REACHED)){
-        node = queue_head(q);
-        /*Actualización de niveles de distancia de los nodos vecinos de 'node'*/
-        set_lvlNbrs(dova, node, qNext);
-        /*Agrego 'node' al corte*/
-        HASH_ADD(hhCut, dova->cut, name, sizeof(dova->cut->name), node);
-        queue_dequeue(q);
-        /*Si se terminaron los nodos de este nivel, se pasa al siguiente*/
-        if(queue_isEmpty(q))
-            queue_swap(&q, &qNext);
-    }
-    /*Si se alcanzo 't'*/
-    if(IS_SET_FLAG(SINK_REACHED)){
-        HASH_CLEAR(hhCut, dova->cut);   /*EL corte no es minimal, no me sirve*/
-    }else
-        SET_FLAG(MAXFLOW);  /*El flujo es maximal => hay corte minimal*/
-
-    queue_destroy(q, NULL);
-    queue_destroy(qNext, NULL);
+    cut_clear(dova);
+    lvl_reset(dova);
+    
+    /*En paralelo solo se arman los niveles. Si no se alcanza 't' el BFS se
+     repite en serie, que arma el corte en el mismo orden de siempre*/
+    if(dova->bfs != NULL){
+        if(bfs_run(dova->bfs, dova->csr, dova->n, dova->lvl, dova->s, dova->t))
+            SET_FLAG(SINK_REACHED);
+        else
+            lvl_reset(dova);
+    }
+    if(!IS_SET_FLAG(SINK_REACHED)){
+        /*La fuente es nivel 0*/
+        dova->lvl[dova->s] = 0;
+        dova->frontier[tail++] = dova->s;
+
+        /*Actualización de distancias por BFS. Cada nodo entra una sola vez a
+         la cola, así que nunca pasa de 'n'*/
+        while(head < tail && !IS_SET_FLAG(SINK_REACHED)){
+            x = dova->frontier[head++];
+            /*Actualización de niveles de distancia de los nodos vecinos*/
+            set_lvlNbrs(dova, x, &tail);
+        }
+        /*Si no se alcanzo 't' el flujo es maximal => hay corte minimal, y sus
+         nodos son todos los que pasaron por la cola*/
+        if(!IS_SET_FLAG(SINK_REACHED)){
+            cut_fill(dova, tail);
+            SET_FLAG(MAXFLOW);
+        }
+    }
+    /*Se descartan los nodos desde los que no se llega a 't'*/
+    if(IS_SET_FLAG(SINK_REACHED) && IS_SET_FLAG(PRUNE))
+        lvl_prune(dova);
     return IS_SET_FLAG(SINK_REACHED);
 }
 
@@ -369,61 +960,55 @@ int ActualizarDistancias(DovahkiinP dova){
  * tiene una distancia +1 que el, y si se puede aumentar (o disminuir) flujo 
  * entre ellos.
  * El nodo es anulado si no tiene un siguiente a quien enviar flujo.
- * \note El camino al ser el resultado de un DFS es una pila y se usa el nodo 
- * top para avanzar hacia 't'. Si este nodo no tiene vecinos por los que se 
- * pueda avanzar entonces se quita de la pila y se bloquea para que no se vuelva
- * a usar. Se continua intentando avanzar de esta manera hasta llegar a 't' o
- * hasta que no queden mas nodos en la pila.
+ * \note El camino al ser el resultado de un DFS es una pila de arcos, y se usa
+ * la cabeza del último para avanzar hacia 't'. Si ese nodo no tiene vecinos
+ * por los que se pueda avanzar entonces se quita su arco de la pila y se
+ * bloquea para que no se vuelva a usar. Se continua intentando avanzar de esta
+ * manera hasta llegar a 't' o hasta bloquear 's'. \n
+ * Junto con cada arco se guarda el mínimo residuo del camino hasta él, por lo
+ * que al llegar a 't' ya se conoce cuánto flujo admite el camino.
  * \param dova  El dova en el que se trabaja.
  * \pre \p dova Debe ser un DovahkiinP no nulo.
  * \return  1 si llega a 't'. \n
  *          0 caso contrario.
  */
 int BusquedaCaminoAumentante(DovahkiinP dova){
-    Network *x = NULL;      /*Ultimo nodo agregado al path (ancestro)*/
-    Network *y = NULL;      /*Nodo candidato a agregarse al path*/
+    u64 x;                  /*Cabeza del camino (ancestro)*/
+    u64 k;                  /*Cantidad de arcos en el camino*/
+    u64 arc;                /*Arco por el que se avanza*/
     int t_reached = 0;      /*Indica si se alcanzó 't'*/
-    short int dir;          /*Dirección de un nodo con su ancestro en el path*/
-    /*Network *k = NULL;*/  /*Iterador para reseteo de direcciones*/
     
     assert(dova != NULL);
-    /* Reset de direcciones(solo sirve por motivos de debuggin y aumenta el 
-     *tiempo de procesamiento)*/
-    /*for(k = dova->net; k != NULL; k = k->hhNet.next){
-        k->pDir = DIR_NIL;
-    }*/
-    
     /*No se busca un nuevo camino aumentante si uno anterior encontrado todavía
      no se uso para aumentar flujo*/
     if (IS_SET_FLAG(PATHUSED)){
-        if (dova->path != NULL)
-            stack_destroy(dova->path, NULL);    /*Destruyo el path viejo*/
-        dova->path = stack_create();
-        /*Busco a 's' y lo agrego al path (notar 'x' = 's')*/
-        HASH_FIND(hhNet, dova->net, &(dova->src), sizeof(dova->src), x); 
-        stack_push(dova->path, x);
-        while(!stack_isEmpty(dova->path) && (x->name != dova->snk)){
+        /*El camino empieza en 's', sin arcos*/
+        x = dova->s;
+        k = 0;
+        while(x != dova->t){
             /*Busco el siguiente nodo que cualifica para el camino aumentante*/
-            y = network_nextNode(dova->net, x, &dir);
-            if(y != NULL){
-                /*Se agrega al camino con la dirección que es agregado*/
-                y->pDir = dir;
-                stack_push(dova->path, y);
-                x = y;
-            }else{  
-                /*No se puede avanzar. Bloqueo y pruebo con el próximo top.*/
-                x->lvl = LVL_NIL;
-                stack_pop(dova->path);
-                x = (Network*)stack_top(dova->path); 
+            if(network_nextArc(dova, x, &arc)){
+                dova->path[k] = arc;
+                dova->pathMin[k+1] = u64_min(dova->pathMin[k],
+                                        nbrhd_arcResidual(dova->csr, arc));
+                k++;
+                x = nbrhd_arcHead(dova->csr, arc);
+            }else{
+                /*No se puede avanzar. Bloqueo y vuelvo al nodo anterior.*/
+                dova->lvl[x] = LVL_NIL;
+                if(k == 0)
+                    break;
+                k--;
+                x = nbrhd_arcHead(dova->csr,
+                                  nbrhd_arcPair(dova->csr, dova->path[k]));
             }
         }
+        dova->pathLen = k;
+        /*Si se encontró camino aumentante es que llego a 't'*/
+        if (x == dova->t) /*El path se puede usar para aumentar flujo*/
+            UNSET_FLAG(PATHUSED);
     }
-    /*Si se encontró camino aumentante es que llego a 't'*/
-    if (dova->path != NULL && !stack_isEmpty(dova->path)){
-        t_reached = ((Network*)stack_top(dova->path))->name == dova->snk;
-        if (t_reached) /*El path se puede usar para aumentar flujo*/
-            UNSET_FLAG(PATHUSED); 
-    }
+    t_reached = !IS_SET_FLAG(PATHUSED);
     return t_reached;
 }
 
@@ -440,18 +1025,16 @@ int BusquedaCaminoAumentante(DovahkiinP dova){
  */
 u64 AumentarFlujo(DovahkiinP dova){
     u64 pflow = 0;      /*Flujo a enviar por el camino aumentante*/ 
-    Network *x = NULL;  /*Nodo 'x' de una arista 'xy'. Ancestro de 'y'*/
-    Network *y = NULL;  /*Nodo 'y' de una arista 'xy'*/
+    u64 k;              /*Iterador sobre los arcos del camino*/
     
     assert(dova != NULL);
     /*Precondicion de que el camino no se uso para aumentar flujo*/
     if (!IS_SET_FLAG(PATHUSED)){
-        pflow = get_pathFlow(dova);
-        /*Incremento del flujo sobre cada arista 'xy'.*/
-        PATH_ITER(dova->path, x, y){
-            /*por BWD se reduce el flujo sobre esta arista*/
-            nbrhd_increaseFlow(x->nbrs, y->name, y->pDir, pflow);
-        }
+        pflow = dova->pathMin[dova->pathLen];
+        /*Incremento del flujo sobre cada arco. Por BWD se reduce el flujo
+         sobre esa arista*/
+        for(k = 0; k < dova->pathLen; k++)
+            nbrhd_arcPush(dova->csr, dova->path[k], pflow);
         dova->flow += pflow; 
         dova->pCounter++;
     }
@@ -473,8 +1056,9 @@ u64 AumentarFlujo(DovahkiinP dova){
  */
 u64 AumentarFlujoYTambienImprimirCamino(DovahkiinP dova){
     u64 pflow = 0;      /*Flujo a enviar por el camino aumentante*/ 
-    Network *x = NULL;  /*Nodo 'x' de una arista 'xy'. Ancestro de 'y'*/
-    Network *y = NULL;  /*Nodo 'y' de una arista 'xy'*/
+    u64 k;              /*Posición del arco 'xy' en el camino, desde 't'*/
+    u64 arc;            /*Arco 'xy' del camino*/
+    u64 x;              /*Nodo 'x' de una arista 'xy'. Ancestro de 'y'*/
     
     assert(dova != NULL);
     /*precondición de que el camino no se uso para aumentar flujo*/
@@ -482,22 +1066,135 @@ u64 AumentarFlujoYTambienImprimirCamino(DovahkiinP dova){
         /*Aumento el flujo*/
         pflow = AumentarFlujo(dova);
         /*Imprimo el camino*/ 
-        printf("camino aumentante %"PRIu64":\nt", dova->pCounter );      
-        PATH_ITER(dova->path, x, y){
-            if(y->pDir == FWD){
-                if(x->name != dova->src)
-                    printf(";%"PRIu64, x->name);
+        writer_str(dova->out, "camino aumentante ");
+        writer_u64(dova->out, dova->pCounter);
+        writer_str(dova->out, ":\nt");
+        for(k = dova->pathLen; k > 0; k--){
+            arc = dova->path[k-1];
+            x = nbrhd_arcHead(dova->csr, nbrhd_arcPair(dova->csr, arc));
+            if(nbrhd_arcDir(dova->csr, x, arc) == FWD){
+                writer_char(dova->out, ';');
+                if(x != dova->s)
+                    writer_u64(dova->out, dova->nodes[x]->name);
                 else
-                    printf(";s");
-            }else
-                printf(">%"PRIu64, x->name);
+                    writer_char(dova->out, 's');
+            }else{
+                writer_char(dova->out, '>');
+                writer_u64(dova->out, dova->nodes[x]->name);
+            }
         }
-        printf(": <%"PRIu64">\n", pflow);
+        writer_str(dova->out, ": <");
+        writer_u64(dova->out, pflow);
+        writer_str(dova->out, ">\n");
+        writer_flush(dova->out);
     }
     SET_FLAG(PATHUSED);
     return pflow;
 }
 
+/** Calcula un flujo bloqueante sobre el network de niveles actual.
+ * Hace un único DFS desde 's' que, cada vez que llega a 't', envía por el
+ * camino el máximo flujo posible y retrocede hasta el primer arco que quedó
+ * saturado, para seguir avanzando desde ahí. Los nodos sin salida se bloquean
+ * y los arcos actuales evitan volver a revisar arcos descartados. \n
+ * Los caminos que se usan, y el flujo que resulta, son los mismos que se
+ * obtienen llamando a BusquedaCaminoAumentante() y AumentarFlujo() hasta que
+ * no haya más caminos, pero sin reconstruir el path en cada uno.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, preparado con Prepararse(), y
+ *      la última llamada a ActualizarDistancias() armó el network de niveles.
+ * \return  Valor del flujo bloqueante, que ya se sumó al flujo del network.
+ */
+u64 CalcularFlujoBloqueante(DovahkiinP dova){
+    u64 total = 0;      /*Valor del flujo bloqueante. Retorno*/
+    u64 pflow;          /*Flujo a enviar por el camino encontrado*/
+    u64 top = 0;        /*Posición del último nodo en la pila del DFS*/
+    u64 x;              /*Último nodo en la pila del DFS*/
+    u64 arc;            /*Arco por el que se avanza*/
+    u64 i;              /*Iterador sobre el camino*/
+    u64 *stk;           /*La pila del DFS, con 's' en el fondo*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    stk = dova->dfs;
+    stk[0] = dova->s;
+    /*El DFS termina cuando se bloquea 's'*/
+    while(dova->s != dova->t && dova->lvl[dova->s] != LVL_NIL){
+        x = stk[top];
+        if(x == dova->t){
+            /*Máximo flujo que admite el camino. Cada nodo llegó por pArc*/
+            pflow = u64_MAX;
+            for(i = 1; i <= top; i++){
+                arc = dova->pArc[stk[i]];
+                pflow = u64_min(pflow, nbrhd_arcResidual(dova->csr, arc));
+            }
+            /*Se envía, y se retrocede al origen del primer arco saturado*/
+            for(i = top; i > 0; i--){
+                arc = dova->pArc[stk[i]];
+                nbrhd_arcPush(dova->csr, arc, pflow);
+                if(nbrhd_arcResidual(dova->csr, arc) == 0)
+                    top = i - 1;
+            }
+            total += pflow;
+            dova->pCounter++;
+        }else if(network_nextArc(dova, x, &arc)){
+            /*Se avanza hacia el vecino por 'arc'*/
+            top++;
+            stk[top] = nbrhd_arcHead(dova->csr, arc);
+            dova->pArc[stk[top]] = arc;
+        }else{
+            /*No se puede avanzar. Bloqueo y retrocedo*/
+            dova->lvl[x] = LVL_NIL;
+            if(top > 0)
+                top--;
+        }
+    }
+    dova->flow += total;
+    /*Un camino encontrado antes quedó sin sentido*/
+    SET_FLAG(PATHUSED);
+    return total;
+}
+
+/** Calcula el flujo maximal del network con Dinic, de una sola vez.
+ * Alterna ActualizarDistancias() y CalcularFlujoBloqueante() hasta que no se
+ * alcance 't', sin pasar por el protocolo de a un camino de
+ * BusquedaCaminoAumentante() y AumentarFlujo(). Al terminar, el flujo es
+ * maximal y quedan armados el corte minimal y el flujo de cada lado, por lo
+ * que se pueden usar ImprimirFlujo(), ImprimirValorFlujo() e ImprimirCorte().
+ * \note Si se eligió push-relabel con FijarMotor(), se usa en lugar de Dinic
+ * y luego se llama una vez a ActualizarDistancias(), que ya no alcanza 't' y
+ * arma el corte.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova Debe ser un DovahkiinP no nulo, preparado con Prepararse().
+ * \return  Valor del flujo maximal.
+ */
+u64 CalcularFlujoMaximal(DovahkiinP dova){
+    Bfs bfs = NULL;     /*Buscador para push-relabel en paralelo*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    if (dova->engine == MOTOR_DINIC){
+        while(ActualizarDistancias(dova))
+            CalcularFlujoBloqueante(dova);
+    }else{
+        if (dova->s != dova->t && dova->engine == MOTOR_PAR){
+            /*Sin hilos fijados se trabaja con uno solo*/
+            bfs = dova->bfs != NULL ? dova->bfs : bfs_create(1);
+            dova->flow += preflow_maxFlowPar(dova->csr, dova->n, dova->s, 
+                                             dova->t, bfs);
+            if (bfs != dova->bfs)
+                bfs_destroy(bfs);
+        }else if (dova->s != dova->t)
+            dova->flow += preflow_maxFlow(dova->csr, dova->n, dova->s, dova->t,
+                            dova->engine == MOTOR_HL ? PREFLOW_HL : PREFLOW_FIFO);
+        /*Un camino encontrado antes quedó sin sentido*/
+        SET_FLAG(PATHUSED);
+        ActualizarDistancias(dova);
+    }
+    
+    return dova->flow;
+}
+
 /** Imprime por Estandar Output el Flujo hasta el momento. 
  * Imprime con el formato: \n
  * \verbatim Flujo �:
@@ -509,29 +1206,48 @@ u64 AumentarFlujoYTambienImprimirCamino(DovahkiinP dova){
  */
 void ImprimirFlujo(DovahkiinP dova){
     Network *x = NULL;      /*Nodo actual de la iteración.*/
-    Network *ref = NULL;    /*Lo necesita HASH_ITER para no perder referencias*/
+    NbrhdIter it;           /*Iterador sobre los vecinos forward de 'x'*/
     u64 yName;              /*Nombre del nodo 'y', vecino del nodo 'x'*/
     u64 vflow = 0;          /*Valor del flujo del lado a imprimir*/
-    int rqst;               /*Manejo de rqst para la búsqueda de nodos vecinos*/
+    u64 a, end;             /*Arco de 'x' y fin de sus arcos*/
+    u64 i;                  /*Id del nodo actual*/
     
     assert(dova != NULL);
     
+    /*El flujo de cada lado se lleva de la CSR a las vecindades. Así no
+     aparecen los lados quitados con EliminarLado(), que siguen en la CSR*/
+    if(dova->csr != NULL && dova->snap == NULL)
+        nbrhd_sync(dova->csr, dova->nbrs, dova->n);
     if(IS_SET_FLAG(MAXFLOW))
-        printf("Flujo maximal:\n");
+        writer_str(dova->out, "Flujo maximal:\n");
     else
-        printf("Flujo no maximal:\n");
-    /*Itero sobre cada nodo del network.*/
-    HASH_ITER(hhNet, dova->net, x, ref){
-        rqst = FST;
-        /*Imprimo todos los lados 'xy' hasta acabar los vecinos*/
-        while(nbrhd_getFwd(x->nbrs, rqst, &yName)){
-            vflow = nbrhd_getFlow(x->nbrs, yName, FWD);
-            printf("Lado %"PRIu64",%"PRIu64": %"PRIu64"\n",x->name, yName, 
-                   vflow);
-            rqst = NXT;
+        writer_str(dova->out, "Flujo no maximal:\n");
+    /*Itero sobre cada nodo del network, en el orden en que se cargaron.*/
+    for(i = 0; i < dova->n; i++){
+        x = dova->nodes[i];
+        if(dova->snap != NULL){
+            /*Los arcos FWD están en el orden de los vecinos, y el flujo de
+             cada lado es el residuo de su arco BWD*/
+            end = nbrhd_arcEnd(dova->csr, i);
+            for(a = nbrhd_arcBegin(dova->csr, i); a < end; a++){
+                if(nbrhd_arcDir(dova->csr, i, a) == FWD){
+                    yName = dova->nodes[nbrhd_arcHead(dova->csr, a)]->name;
+                    vflow = nbrhd_arcResidual(dova->csr, 
+                                              nbrhd_arcPair(dova->csr, a));
+                    out_lado(dova, x->name, yName, vflow);
+                }
+            }
+        }else{
+            nbrhd_iterInit(&it, x->nbrs, FWD);
+            /*Imprimo todos los lados 'xy' hasta acabar los vecinos*/
+            while(nbrhd_iterNext(&it, &yName)){
+                vflow = nbrhd_iterFlow(&it);
+                out_lado(dova, x->name, yName, vflow);
+            }
         }
     }
-    printf("\n");
+    writer_char(dova->out, '\n');
+    writer_flush(dova->out);
 }
 
 /** Imprime por Estandar Output el valor del Flujo calculado hasta el momento. 
@@ -564,202 +1280,942 @@ void ImprimirValorFlujo(DovahkiinP dova){
         Debe existir corte minimal. ie, debe haberse llegado a flujo maximal.
  */  
 void ImprimirCorte(DovahkiinP dova){
-    Network *x = NULL;      /*Nodo que pertenece al corte*/
-    Network *y = NULL;      /*Nodo vecino de 'x'*/
-    Network *ref = NULL;    /*Lo necesita HASH_ITER para no perder referencias*/
-    u64 yName;              /*Nombre del nodo 'y'*/
+    u64 x;                  /*Nodo que pertenece al corte*/
     u64 capCut = 0;         /*Capacidad del corte*/
-    int rqst;               /*Para establecer pedidos de busqueda de vecinos*/
+    u64 count;              /*Cantidad de lados que salen del corte*/
+    u64 i;                  /*Iterador sobre el corte*/
     
     assert(dova!=NULL);
-    assert(dova->cut!=NULL && IS_SET_FLAG(MAXFLOW));
+    assert(dova->csr!=NULL && dova->cutSize > 0 && IS_SET_FLAG(MAXFLOW));
     
-    printf("Corte Minimal: S = {s");
+    capCut = cut_scan(dova, NULL, &count);
+    writer_str(dova->out, "Corte Minimal: S = {s");
     /*Itero sobre cada nodo del corte.*/
-    HASH_ITER(hhCut, dova->cut, x, ref){
-        rqst = FST;
-        /*Itero sobre los vecinos de 'x'*/
-        while(nbrhd_getFwd(x->nbrs, rqst, &yName)){
-            /*Me fijo si el vecino 'y' esta en el corte*/
-            HASH_FIND(hhCut, dova->cut, &yName, sizeof(yName), y);
-            if(y == NULL) /*Esta en el complemento. Sumo la capacidad*/
-                capCut += nbrhd_getCap(x->nbrs, yName, FWD);
-            rqst = NXT;
+    for(i = 0; i < dova->cutSize; i++){
+        x = dova->cut[i];
+        if(x != dova->s){
+            writer_char(dova->out, ',');
+            writer_u64(dova->out, dova->nodes[x]->name);
         }
-        if(x->name != dova->src)
-            printf(",%"PRIu64, x->name);
     }
-    printf("}\n");
-    printf("Capacidad: %"PRIu64"\n", capCut);
+    writer_str(dova->out, "}\nCapacidad: ");
+    writer_u64(dova->out, capCut);
+    writer_char(dova->out, '\n');
+    writer_flush(dova->out);
 }
 
-
-
-/* 
- *          Funciones estáticas
-*/
-
-/** Busca el máximo valor de flujo que se puede enviar por un camino sin usar.
+/** Devuelve el corte minimal en arreglos, para usarlo sin leer la salida de
+ * ImprimirCorte().
+ * En \p corte quedan los nombres de los nodos del corte, empezando por 's' y
+ * en el orden en que se alcanzaron, y los lados que salen del corte hacia su
+ * complemento (incluso los de capacidad 0, no los quitados con
+ * EliminarLado()), como ternas (x, y, capacidad) seguidas, junto con la
+ * capacidad del corte. Los arreglos se liberan con LiberarCorte().
  * \param dova  El dova en el que se trabaja.
- * \pre \p dova Debe ser un DovahkiinP no nulo. \n.
- *      El camino aumentante todavía no se uso para aumentar flujo.
- * \return  Valor por el cual se aumenta el flujo.
+ * \param corte Donde se almacena el corte.
+ * \pre \p dova Debe ser un DovahkiinP no nulo y \p corte no nulo.
+ * \return  1 si hay corte minimal (se llegó a flujo maximal) y se almacenó.
+ *          0 caso contrario, y \p corte queda vacío.
  */
-static u64 get_pathFlow(DovahkiinP dova){
-    u64 pflow = u64_MAX;    /*valor de flujo de retorno*/
-    u64 cap, flow;          /*capacidad y valor de flujo*/
-    Network *x = NULL;      /*nodo 'x'*/
-    Network *y = NULL;      /*nodo 'y'*/
+int ObtenerCorte(DovahkiinP dova, Corte *corte){
+    u64 i;                  /*Iterador sobre el corte*/
+    int result = 0;         /*Hay corte minimal. Retorno*/
     
-    assert(dova != NULL);
-    assert(!IS_SET_FLAG(PATHUSED));
-    /*Itero en el camino. 'x' es ancestro de 'y'*/
-    PATH_ITER(dova->path, x, y){
-        flow = nbrhd_getFlow(x->nbrs, y->name, y->pDir);
-        /*El calculo depende de la dirección en la que fue agregado 'y'*/
-        if(y->pDir == FWD){
-            /*'y' es vecino forward.*/
-            cap = nbrhd_getCap(x->nbrs, y->name, FWD);
-            pflow = u64_min(pflow, cap - flow);
-        }else
-            /*'y' es vecino backward.*/
-            pflow = u64_min(pflow, flow);
+    assert(dova != NULL && corte != NULL);
+    
+    corte->nodos = NULL;
+    corte->cantNodos = 0;
+    corte->lados = NULL;
+    corte->cantLados = 0;
+    corte->capacidad = 0;
+    if (dova->csr != NULL && dova->cutSize > 0 && IS_SET_FLAG(MAXFLOW)){
+        corte->cantNodos = dova->cutSize;
+        corte->nodos = (u64*) malloc(dova->cutSize * sizeof(u64));
+        assert(corte->nodos != NULL);
+        for(i = 0; i < dova->cutSize; i++)
+            corte->nodos[i] = dova->nodes[dova->cut[i]]->name;
+        /*Primero se cuentan los lados, y luego se copian*/
+        cut_scan(dova, NULL, &corte->cantLados);
+        corte->lados = (u64*) malloc((3 * corte->cantLados + 1) * sizeof(u64));
+        assert(corte->lados != NULL);
+        corte->capacidad = cut_scan(dova, corte->lados, &corte->cantLados);
+        result = 1;
     }
-    return pflow;
+    return result;
 }
 
+/** Escribe en el archivo \p path el flujo de cada lado, para que lo lean
+ * otros programas sin parsear la salida de ImprimirFlujo().
+ * Se escribe el valor del flujo y si es maximal, los lados (salvo los quitados
+ * con EliminarLado()) en el mismo orden que ImprimirFlujo(), y si el flujo es
+ * maximal los nombres de los nodos del corte, empezando por 's'. Los lados
+ * salen de los arcos FWD de la CSR, que se arma si no existe, y todo pasa por
+ * un Writer sobre el archivo, sin printf. \n
+ * Con VOLCADO_BIN todo son u64 little-endian: un encabezado de 5 (DUMP_MAGIC,
+ * el valor del flujo, 1 si es maximal o 0 si no, la cantidad de lados y la de
+ * nodos del corte), una terna (x, y, flujo) por lado y un nombre por nodo del
+ * corte. Con VOLCADO_CSV se escribe: \n
+ * \verbatim valor,maximal
+   <ValorDelFlujo>,<1 o 0>
+   x,y,flujo
+   x_1,y_1,<FlujoDelLado>
+   corte
+   <Fuente>
+   x_1
+   \endverbatim
+ * Donde la sección del corte solo está si el flujo es maximal.
+ * \param dova    El dova en el que se trabaja.
+ * \param path    Ruta del archivo a escribir.
+ * \param formato VOLCADO_BIN o VOLCADO_CSV.
+ * \pre \p dova Debe ser un DovahkiinP no nulo y \p path no nulo.
+ * \return  1 si se escribió el archivo.
+ *          0 si no se pudo escribir.
+ */
+int VolcarFlujo(DovahkiinP dova, const char *path, int formato){
+    Writer W = NULL;        /*Salida sobre el archivo*/
+    int fd;                 /*El archivo del volcado*/
+    u64 maximal;            /*1 si el flujo es maximal y hay corte*/
+    u64 cutSize;            /*Cantidad de nodos del corte que se escriben*/
+    u64 i;                  /*Iterador sobre el corte*/
+    bool ok = false;        /*No falló ninguna escritura*/
+    
+    assert(dova != NULL && path != NULL);
+    assert(formato == VOLCADO_BIN || formato == VOLCADO_CSV);
+    
+    if (dova->csr == NULL)
+        dova_freeze(dova);
+    maximal = (IS_SET_FLAG(MAXFLOW)) && dova->cutSize > 0 ? 1 : 0;
+    cutSize = maximal ? dova->cutSize : 0;
+    fd = open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd >= 0){
+        W = writer_create(fd);
+        if (formato == VOLCADO_BIN){
+            writer_u64le(W, DUMP_MAGIC);
+            writer_u64le(W, dova->flow);
+            writer_u64le(W, maximal);
+            writer_u64le(W, dump_edges(dova, NULL, formato));
+            writer_u64le(W, cutSize);
+            dump_edges(dova, W, formato);
+            for(i = 0; i < cutSize; i++)
+                writer_u64le(W, dova->nodes[dova->cut[i]]->name);
+        }else{
+            writer_str(W, "valor,maximal\n");
+            writer_u64(W, dova->flow);
+            writer_char(W, ',');
+            writer_u64(W, maximal);
+            writer_str(W, "\nx,y,flujo\n");
+            dump_edges(dova, W, formato);
+            if (maximal)
+                writer_str(W, "corte\n");
+            for(i = 0; i < cutSize; i++){
+                writer_u64(W, dova->nodes[dova->cut[i]]->name);
+                writer_char(W, '\n');
+            }
+        }
+        ok = writer_flush(W);
+        writer_destroy(W);
+        ok = close(fd) == 0 && ok;
+    }
+    return ok ? 1 : 0;
+}
+
+/** Libera los arreglos de un corte obtenido con ObtenerCorte().
+ * \param corte El corte a liberar.
+ * \pre \p corte no es nulo.
+ */
+void LiberarCorte(Corte *corte){
+    assert(corte != NULL);
+    free(corte->nodos);
+    free(corte->lados);
+    corte->nodos = NULL;
+    corte->cantNodos = 0;
+    corte->lados = NULL;
+    corte->cantLados = 0;
+}
+
+
+
+/* 
+ *          Funciones estáticas
+*/
+
 /** Creador de un nuevo Network.
- * \param n El nombre del nodo.
+ * El nodo y sus vecinos se piden a la arena, y se liberan con ella.
+ * \param arena La arena de la que se pide la memoria.
+ * \param n  El nombre del nodo.
+ * \param id El id del nodo.
  * \return Un Network con nombre de nodo 'n'.
  */
-static Network *network_create(u64 n){
+static Network *network_create(Arena arena, u64 n, u64 id){
     Network *node;
     
-    node = (Network*) malloc(sizeof(Network));
-    assert(node != NULL);
+    node = (Network*) arena_alloc(arena, sizeof(Network));
     
     node->name = n;
-    node->nbrs = nbrhd_create();
-    node->lvl = LVL_NIL;
-    node->pDir = DIR_NIL;
+    node->nbrs = nbrhd_create(arena);
+    node->id = id;
     
     return node;
 }
 
-/** Destructor de un Network.
- * \pre El Network no es nulo.
- * \param net El Network a destruir.
+/** Agrega un nodo al network, si todavía no existe.
+ * Los nodos nuevos reciben como id el siguiente libre, que es el orden en que
+ * fueron cargados, y se registran en 'nodes' bajo ese id.
+ * \param dova  El dova en el que se trabaja.
+ * \param name  El nombre del nodo.
+ * \pre \p dova no es nulo.
+ * \return El nodo del network con nombre \p name.
  */
-static void network_destroy(Network *net){
-    assert(net!=NULL);
-    nbrhd_destroy(net->nbrs);
-    free(net);
+static Network *network_add(DovahkiinP dova, u64 name){
+    Network *node = NULL;   /*El nodo buscado o creado. Retorno*/
+    
+    assert(dova != NULL && dova->snap == NULL);
+    HASH_FIND(hhNet, dova->net, &name, sizeof(name), node);
+    if (node == NULL){
+        /*Si no hay lugar para el nuevo id, se duplica el arreglo de nodos*/
+        if (dova->n == dova->size){
+            dova->size = dova->size == 0 ? 64 : 2 * dova->size;
+            dova->nodes = (Network**) realloc(dova->nodes, 
+                                              dova->size * sizeof(Network*));
+            assert(dova->nodes != NULL);
+        }
+        node = network_create(dova->arena, name, dova->n);
+        HASH_ADD(hhNet, dova->net, name, sizeof(node->name), node);
+        dova->nodes[dova->n] = node;
+        dova->n++;
+    }
+    return node;
 }
 
-/** Busca el siguiente nodo que cumple las condiciones de envío de flujo.
- * En relación con un nodo, se busca un siguiente que sea vecino de este y que
+/** Busca un nodo del network por su nombre.
+ * \param dova  El dova en el que se trabaja.
+ * \param name  El nombre del nodo.
+ * \pre \p dova no es nulo.
+ * \return El nodo con nombre \p name, o NULL si no existe.
+ */
+static Network *network_find(DovahkiinP dova, u64 name){
+    Network *node = NULL;   /*El nodo buscado. Retorno*/
+    
+    assert(dova != NULL);
+    network_index(dova);
+    HASH_FIND(hhNet, dova->net, &name, sizeof(name), node);
+    return node;
+}
+
+/** Arma la tabla hash de los nombres de los nodos de un snapshot, si todavía
+ * no existe. No se arma al cargarlo, que costaría más que el resto de la
+ * carga, sino en la primera búsqueda por nombre; desde ahí cada búsqueda es
+ * O(1), como en un network cargado de a lados.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo.
+ */
+static void network_index(DovahkiinP dova){
+    Network *x = NULL;  /*Nodo actual*/
+    u64 i;              /*Id del nodo actual*/
+    
+    assert(dova != NULL);
+    if (dova->snap != NULL && dova->net == NULL){
+        for(i = 0; i < dova->n; i++){
+            x = dova->nodes[i];
+            HASH_ADD(hhNet, dova->net, name, sizeof(x->name), x);
+        }
+    }
+}
+
+/** Busca el siguiente arco que cumple las condiciones de envío de flujo.
+ * En relación con un nodo, se busca un arco hacia un vecino de este tal que
  * entre ellos haya posibilidad de enviar flujo. La búsqueda es prioritaria por
  * forward, si no encuentra ninguno entonces intenta por backward. \n
- * \param net El Network que los nodos pertenecen.
- * \param x El nodo ancestro.
- * \param dir Puntero donde almacenar la dirección que se encuentra el vecino (FWD o BWD).
- * \pre El network y el nodo no son nulos.
- * \return  Puntero al nodo encontrado. \n
- *          NULL si no hay un siguiente que cualifique.
+ * La búsqueda arranca desde el arco actual de 'x' y lo deja en el arco
+ * encontrado. Los arcos salteados no vuelven a cualificar en el mismo nivel de
+ * distancias: o llevan a un nodo fuera del siguiente nivel (o bloqueado), o no
+ * tienen capacidad residual, que solo se recupera enviando flujo desde un
+ * nivel mayor hacia uno menor.
+ * \param dova El dova en el que se trabaja.
+ * \param x El id del nodo ancestro.
+ * \param arc Puntero donde almacenar el arco por el que se llega al vecino.
+ * \pre El dova no es nulo y 'x' es un id valido.
+ * \return  true si se encontró un arco y se almacenó en \p arc. \n
+ *          false si no hay un siguiente que cualifique.
 */
-static Network *network_nextNode(Network *net, Network *x, short int *dir){
-    Network *y = NULL;    /*El nodo candidato a ser el siguiente. Retorno*/
-    int getNbr;           /*Resultado de los nbrhd_getX()*/
-    u64 yName;            /*Nombre del nodo 'y'*/
-    u64 flow, cap;        /*Flujo y capacidad entre 'x' e 'y'*/
+static bool network_nextArc(DovahkiinP dova, u64 x, u64 *arc){
+    u64 y;                /*El vecino por el arco actual*/
+    u64 a, end;           /*Arco actual y fin de los arcos de 'x'*/
     bool breakW = false;  /*Termina la búsqueda iterativa*/
     
-    assert(net != NULL && x != NULL);
-    /*Inicio con el primer vecino que encuentre*/
-    getNbr = nbrhd_getFwd(x->nbrs, FST, &yName);
-    if(!getNbr){
-        getNbr = nbrhd_getBwd(x->nbrs, FST, &yName);
-        *dir = BWD;
-    }else
-        *dir = FWD;
-        
-    while(getNbr && !breakW){
-        HASH_FIND(hhNet, net, &yName, sizeof(yName), y);
-        assert(y!=NULL);
+    assert(dova != NULL && x < dova->n);
+    /*Los arcos FWD están antes que los BWD, asi que la prioridad se respeta*/
+    end = nbrhd_arcEnd(dova->csr, x);
+    for(a = dova->cur[x]; a < end && !breakW; a++){
+        y = nbrhd_arcHead(dova->csr, a);
         /*Compruebo si su distancia es mayor por 1 unidad*/
-        if(y->lvl != LVL_NIL && y->lvl == (x->lvl+1)){ 
-            flow = nbrhd_getFlow(x->nbrs, yName, *dir);
-            cap = nbrhd_getCap(x->nbrs, yName, *dir);
+        if(dova->lvl[y] != LVL_NIL && dova->lvl[y] == (dova->lvl[x]+1)){ 
             /*Compruebo el envio de flujo. True = Cumple lo requerido! salgo*/
-            breakW = (*dir == FWD && cap > flow) || (*dir == BWD && flow > 0);
+            breakW = nbrhd_arcResidual(dova->csr, a) > 0;
+            if(breakW)
+                *arc = a;
         }
-        /*Si no es valido, se descarta y busca otro (prioridad por FWD)*/
-        if(*dir == FWD && !breakW){
-            getNbr = nbrhd_getFwd(x->nbrs, NXT, &yName);
-            if(!getNbr){   /*Se acabaron los FWD, sigo con los BWD*/
-                getNbr = nbrhd_getBwd(x->nbrs, FST, &yName);
-                *dir = BWD;
-            }
-        }else if(*dir == BWD && !breakW)
-            getNbr = nbrhd_getBwd(x->nbrs, NXT, &yName);
     }
+    /*El arco actual queda en el encontrado, que puede volver a usarse*/
+    dova->cur[x] = breakW ? *arc : end;
+    
+    return breakW;
+}
 
-    if(!breakW && !getNbr)
-        y = NULL;   /*Ningún vecino cualifica*/
+/** Busca el arco FWD del lado 'xy' en la CSR.
+ * \param dova  El dova en el que se trabaja.
+ * \param x     El id del nodo 'x'.
+ * \param y     El id del nodo 'y'.
+ * \param arc   Puntero donde almacenar el arco encontrado.
+ * \pre \p dova no es nulo y tiene una CSR armada. 'x' e 'y' son ids validos.
+ * \return  true si el lado existe y su arco se almacenó en \p arc. \n
+ *          false caso contrario.
+ */
+static bool network_findArc(DovahkiinP dova, u64 x, u64 y, u64 *arc){
+    u64 a, end;             /*Arco actual y fin de los arcos de 'x'*/
+    bool found = false;     /*Se encontró el arco. Retorno*/
     
-    return y;
+    assert(dova != NULL && dova->csr != NULL && arc != NULL);
+    assert(x < dova->n && y < dova->n);
+    end = nbrhd_arcEnd(dova->csr, x);
+    for(a = nbrhd_arcBegin(dova->csr, x); a < end && !found; a++){
+        if (nbrhd_arcDir(dova->csr, x, a) == FWD && 
+            nbrhd_arcHead(dova->csr, a) == y){
+            *arc = a;
+            found = true;
+        }
+    }
+    return found;
 }
 
 /** Actualiza los niveles de distancias de los vecinos forward y luego los
  * backward de un nodo.
  * Solo se actualizan vecinos que todavía no tienen su nivel fijado (ie, su 
  * nivel es nulo) y por el que se pueda enviar flujo. Tendrán un nivel de 
- * distancia +1 respecto a su ancestro, y se agregan a una cola que el llamador 
- * debe proporcionar y se encarga de liberar.
+ * distancia +1 respecto a su ancestro, y se agregan al final de la cola
+ * 'frontier' del dova.
  * \param dova  El dova en el que se trabaja.
  * \param x     Nodo ancestro.
- * \param upd   Cola en la que se agregan vecinos que se actualicen.
- * \pre 'dova', 'x' y 'upd' No deben ser nulos.
+ * \param tail  Fin de la cola 'frontier', que avanza con cada vecino agregado.
+ * \pre 'dova' y 'tail' No deben ser nulos y 'x' es un id valido.
  */
-static void set_lvlNbrs(DovahkiinP dova, Network *x, Queue upd){
-    Network *y = NULL;      /*Nodo 'y' vecino de 'x' por actualizar*/
-    int getNbr;             /*Resultado de los nbrhd_getX()*/
-    int dir = FWD;          /*Dirección en la que se encuentra el vecino*/
-    u64 yName, cap, flow;   /*Nombre del nodo 'y', capacidad y flujo con 'x'*/
+static void set_lvlNbrs(DovahkiinP dova, u64 x, u64 *tail){
+    u64 y;                  /*Nodo 'y' vecino de 'x' por actualizar*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'x'*/
     
     assert(dova != NULL);
-    assert(x != NULL && upd != NULL);
-    
-    /*Inicio con el primer vecino que encuentre*/
-    getNbr = nbrhd_getFwd(x->nbrs, FST, &yName);
-    if(!getNbr){
-        getNbr = nbrhd_getBwd(x->nbrs, FST, &yName);
-        dir = BWD;
-    }
-    /*No paro hasta que alcance 't' o se me acaben los vecinos*/
-    while(getNbr && !IS_SET_FLAG(SINK_REACHED)){
-        flow = nbrhd_getFlow(x->nbrs, yName, dir);
-        cap = nbrhd_getCap(x->nbrs, yName, dir);
-        /*Según su dirección, compruebo el envío de flujo*/
-        if((dir == FWD && cap > flow) || (dir == BWD && flow > 0)){
+    assert(x < dova->n && tail != NULL);
+    
+    /*No paro hasta que alcance 't' o se me acaben los vecinos (primero los 
+     FWD y luego los BWD)*/
+    end = nbrhd_arcEnd(dova->csr, x);
+    for(a = nbrhd_arcBegin(dova->csr, x); 
+        a < end && !IS_SET_FLAG(SINK_REACHED); a++){
+        /*Compruebo el envío de flujo, sin importar la dirección del arco*/
+        if(nbrhd_arcResidual(dova->csr, a) > 0){
             /*Busco el nodo y actualizo su nivel (si todavía no lo hizo)*/
-            HASH_FIND(hhNet, dova->net, &yName, sizeof(yName), y);
-            assert(y != NULL);
-            if(y->lvl == LVL_NIL){
-                y->lvl = x->lvl + 1;
-                queue_enqueue(upd, y);
-                if(yName == dova->snk)  /*Se llego a t*/
+            y = nbrhd_arcHead(dova->csr, a);
+            if(dova->lvl[y] == LVL_NIL){
+                dova->lvl[y] = dova->lvl[x] + 1;
+                dova->frontier[(*tail)++] = y;
+                if(y == dova->t)  /*Se llego a t*/
                     SET_FLAG(SINK_REACHED);
             }
         }
-        /*Busco el siguiente vecino*/
-        if(dir == FWD && !IS_SET_FLAG(SINK_REACHED)){
-            getNbr = nbrhd_getFwd(x->nbrs, NXT, &yName);
-            if(!getNbr){   /*Se acabaron los FWD, sigo con los BWD*/
-                getNbr = nbrhd_getBwd(x->nbrs, FST, &yName);
-                dir = BWD;
+    }
+}
+
+/** Carga el lado 'xy' de capacidad 'c' en el network.
+ * Se crean los nodos que todavía no existan y se establecen como vecinos.
+ * \param dova  El dova en el que se trabaja.
+ * \param x     Nombre del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \param c     Capacidad del lado.
+ * \pre \p dova no es nulo.
+ */
+static void dova_addEdge(DovahkiinP dova, u64 x, u64 y, u64 c){
+    Network *xNode = NULL;  /*Nodo 'x'*/
+    Network *yNode = NULL;  /*Nodo 'y'*/
+    
+    assert(dova != NULL);
+    /*Los lados de un snapshot pasan a las vecindades, como si se hubieran
+     cargado de a uno*/
+    if (dova->snap != NULL)
+        dova_unpack(dova);
+    /*Si ya se había congelado, la CSR deja de representar al network*/
+    if (dova->csr != NULL)
+        dova_thaw(dova);
+    /*Cargo los nodos 'x' e 'y', si todavía no existen en el network*/
+    xNode = network_add(dova, x);
+    yNode = network_add(dova, y);
+    /*Se establecen como vecinos. Arista 'xy'*/
+    nbrhd_addEdge(xNode->nbrs, yNode->nbrs, x, y, c);
+}
+
+/** Carga en el dova todos los lados que lea \p sc, hasta la primera linea
+ * que no sea valida o el fin de los datos.
+ * \param dova  El dova en el que se trabaja.
+ * \param sc    El lector de los lados.
+ * \pre \p dova y \p sc no son nulos.
+ * \return Cantidad de lados cargados.
+ */
+static u64 dova_scanEdges(DovahkiinP dova, LadoScanner sc){
+    u64 x, y, c;        /*Datos del lado leído*/
+    u64 count = 0;      /*Cantidad de lados cargados. Retorno*/
+    
+    assert(dova != NULL && sc != NULL);
+    
+    while (parser_scanLado(sc, &x, &y, &c)){
+        dova_addEdge(dova, x, y, c);
+        count++;
+    }
+    return count;
+}
+
+/** Vacía el corte, desmarcando a los nodos que lo conforman.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo.
+ */
+static void cut_clear(DovahkiinP dova){
+    u64 i;  /*Iterador sobre el corte*/
+    u64 x;  /*Nodo del corte*/
+    
+    assert(dova != NULL);
+    for(i = 0; i < dova->cutSize; i++){
+        x = dova->cut[i];
+        dova->inCut[WORD(x)] &= ~BIT(x);
+    }
+    dova->cutSize = 0;
+}
+
+/** Arma el corte con los primeros \p size nodos de la cola del BFS, que son
+ * los que se alcanzaron desde 's', en el orden en que se alcanzaron.
+ * \param dova  El dova en el que se trabaja.
+ * \param size  Cantidad de nodos que pasaron por la cola.
+ * \pre \p dova no es nulo, tiene una CSR armada y el corte está vacío.
+ */
+static void cut_fill(DovahkiinP dova, u64 size){
+    u64 i;  /*Iterador sobre la cola*/
+    u64 x;  /*Nodo del corte*/
+    
+    assert(dova != NULL && dova->csr != NULL && dova->cutSize == 0);
+    for(i = 0; i < size; i++){
+        x = dova->frontier[i];
+        dova->cut[i] = x;
+        dova->inCut[WORD(x)] |= BIT(x);
+    }
+    dova->cutSize = size;
+}
+
+/** Recorre una vez los arcos FWD de los nodos del corte, buscando los lados
+ * que van al complemento.
+ * \param dova  El dova en el que se trabaja.
+ * \param edges Donde se copian los lados, salvo los quitados, como ternas
+ *              (x, y, capacidad) con los nombres de los nodos. Puede ser NULL.
+ * \param count Donde se almacena la cantidad de lados, salvo los quitados.
+ * \pre \p dova no es nulo, tiene una CSR armada y un corte. \p count no es
+ *      nulo, y si \p edges no es nulo tiene lugar para todos los lados.
+ * \return  La capacidad del corte.
+ */
+static u64 cut_scan(DovahkiinP dova, u64 *edges, u64 *count){
+    u64 capCut = 0;     /*Capacidad del corte. Retorno*/
+    u64 x, y;           /*Lado 'xy' que sale del corte*/
+    u64 a, end;         /*Arco de 'x' y fin de sus arcos*/
+    u64 c;              /*Capacidad del lado 'xy'*/
+    u64 i;              /*Iterador sobre el corte*/
+    u64 k = 0;          /*Cantidad de lados encontrados*/
+    
+    assert(dova != NULL && dova->csr != NULL && count != NULL);
+    for(i = 0; i < dova->cutSize; i++){
+        x = dova->cut[i];
+        end = nbrhd_arcEnd(dova->csr, x);
+        for(a = nbrhd_arcBegin(dova->csr, x); a < end; a++){
+            y = nbrhd_arcHead(dova->csr, a);
+            /*Si el vecino esta en el complemento, sumo la capacidad*/
+            if(nbrhd_arcDir(dova->csr, x, a) == FWD && !IN_CUT(dova, y) &&
+               !IS_DEAD(dova, a)){
+                c = nbrhd_arcCap(dova->csr, a);
+                capCut += c;
+                if(edges != NULL){
+                    edges[3*k] = dova->nodes[x]->name;
+                    edges[3*k+1] = dova->nodes[y]->name;
+                    edges[3*k+2] = c;
+                }
+                k++;
+            }
+        }
+    }
+    *count = k;
+    return capCut;
+}
+
+/** Reinicia las distancias y los arcos actuales de todos los nodos.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo y tiene una CSR armada.
+ */
+static void lvl_reset(DovahkiinP dova){
+    u64 i;  /*Id del nodo actual*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    for(i = 0; i < dova->n; i++){
+        dova->lvl[i] = LVL_NIL;
+        dova->cur[i] = nbrhd_arcBegin(dova->csr, i);
+    }
+}
+
+/** Anula el nivel de los nodos que no están en un camino más corto de s a t.
+ * Se hace un BFS hacia atrás desde 't' por los arcos del network de niveles:
+ * un nodo 'v' queda vivo si tiene un arco con residuo hacia un nodo vivo del
+ * nivel siguiente. Los demás nodos no pueden llegar a 't' durante todo el
+ * flujo bloqueante (enviar flujo solo agrega arcos hacia niveles anteriores),
+ * así que anularlos no cambia los caminos que encuentra el DFS, pero le ahorra
+ * recorrerlos y retroceder.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo, tiene una CSR armada y se acaba de alcanzar 't'.
+ */
+static void lvl_prune(DovahkiinP dova){
+    u64 *q;                 /*Cola del BFS, sobre la pila del DFS*/
+    u64 head = 0, tail = 0; /*Extremos de la cola*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'w'*/
+    u64 v, w;               /*Nodo por revisar y nodo vivo que se expande*/
+    u64 i;                  /*Id del nodo actual*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    assert(dova->lvl[dova->t] != LVL_NIL);
+    
+    q = dova->dfs;
+    dova->live[dova->t] = true;
+    q[tail++] = dova->t;
+    while(head < tail){
+        w = q[head++];
+        end = nbrhd_arcEnd(dova->csr, w);
+        for(a = nbrhd_arcBegin(dova->csr, w); a < end && dova->lvl[w] > 0; a++){
+            v = nbrhd_arcHead(dova->csr, a);
+            /*El arco opuesto lleva de 'v' a 'w'*/
+            if(!dova->live[v] && dova->lvl[v] == dova->lvl[w] - 1 &&
+               nbrhd_arcResidual(dova->csr, nbrhd_arcPair(dova->csr, a)) > 0){
+                dova->live[v] = true;
+                q[tail++] = v;
+            }
+        }
+    }
+    /*Anulo los que no quedaron vivos y dejo 'live' limpio para la próxima*/
+    for(i = 0; i < dova->n; i++){
+        if(!dova->live[i])
+            dova->lvl[i] = LVL_NIL;
+        dova->live[i] = false;
+    }
+}
+
+/** Congela las vecindades del network en la CSR.
+ * Cada nodo queda identificado en la CSR por el id que recibió al cargarse, y
+ * se crean los arreglos (indexados por id) con los datos de los algoritmos.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo y no tiene una CSR armada.
+ */
+static void dova_freeze(DovahkiinP dova){
+    u64 i;  /*Id del nodo actual*/
+    
+    assert(dova != NULL && dova->csr == NULL);
+    
+    dova->nbrs = (Nbrhd*) malloc((dova->n + 1) * sizeof(Nbrhd));
+    assert(dova->nbrs != NULL);
+    for(i = 0; i < dova->n; i++)
+        dova->nbrs[i] = dova->nodes[i]->nbrs;
+    dova_alloc(dova);
+    dova->csr = nbrhd_freeze(dova->nbrs, dova->n);
+}
+
+/** Crea los arreglos (indexados por id) con los datos de los algoritmos, que
+ * existen mientras la CSR esté armada.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo y no tiene una CSR armada.
+ */
+static void dova_alloc(DovahkiinP dova){
+    u64 i;  /*Id del nodo actual*/
+    u64 n;  /*Cantidad de nodos*/
+    
+    assert(dova != NULL && dova->csr == NULL);
+    
+    n = dova->n;
+    dova->lvl = (int*) malloc((n + 1) * sizeof(int));
+    dova->pArc = (u64*) malloc((n + 1) * sizeof(u64));
+    dova->cur = (u64*) malloc((n + 1) * sizeof(u64));
+    dova->dfs = (u64*) malloc((n + 1) * sizeof(u64));
+    dova->frontier = (u64*) malloc((n + 1) * sizeof(u64));
+    dova->path = (u64*) malloc((n + 1) * sizeof(u64));
+    dova->pathMin = (u64*) malloc((n + 1) * sizeof(u64));
+    dova->inCut = (u64*) calloc(WORD(n) + 1, sizeof(u64));
+    dova->live = (bool*) calloc(n + 1, sizeof(bool));
+    dova->cut = (u64*) malloc((n + 1) * sizeof(u64));
+    assert(dova->lvl != NULL && dova->pArc != NULL);
+    assert(dova->path != NULL && dova->pathMin != NULL);
+    assert(dova->inCut != NULL && dova->cut != NULL);
+    assert(dova->cur != NULL && dova->dfs != NULL && dova->live != NULL);
+    assert(dova->frontier != NULL);
+    for(i = 0; i < n; i++){
+        dova->lvl[i] = LVL_NIL;
+        dova->pArc[i] = 0;
+        dova->cur[i] = 0;
+    }
+    dova->pathMin[0] = u64_MAX;
+    dova->pathLen = 0;
+    dova->cutSize = 0;
+}
+
+/** Descarta la CSR, dejando el flujo alcanzado en las vecindades.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo y tiene una CSR armada.
+ */
+static void dova_thaw(DovahkiinP dova){
+    assert(dova != NULL && dova->csr != NULL);
+    
+    /*El network va a cambiar*/
+    gh_clear(dova);
+    /*Sin vecindades (un snapshot) no hay a dónde llevar el flujo*/
+    if (dova->nbrs != NULL)
+        nbrhd_sync(dova->csr, dova->nbrs, dova->n);
+    nbrhd_csrDestroy(dova->csr);
+    free(dova->nbrs);
+    free(dova->lvl);
+    free(dova->pArc);
+    free(dova->cur);
+    free(dova->dfs);
+    free(dova->frontier);
+    free(dova->path);
+    free(dova->pathMin);
+    free(dova->inCut);
+    free(dova->dead);
+    free(dova->live);
+    free(dova->cut);
+    dova->csr = NULL;
+    dova->nbrs = NULL;
+    dova->lvl = NULL;
+    dova->pArc = NULL;
+    dova->cur = NULL;
+    dova->dfs = NULL;
+    dova->frontier = NULL;
+    dova->path = NULL;
+    dova->pathMin = NULL;
+    dova->inCut = NULL;
+    dova->dead = NULL;
+    dova->live = NULL;
+    dova->cut = NULL;
+    dova->cutSize = 0;
+}
+
+/** Pasa los lados de un snapshot a las vecindades y descarta el snapshot.
+ * Queda como si el network se hubiera cargado de a lados, con el flujo que
+ * tenía la CSR. Los lados de cada nodo se agregan en el orden de sus arcos,
+ * así que al volver a congelar los arcos FWD quedan en el mismo orden.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo y se cargó con CargarSnapshot().
+ */
+static void dova_unpack(DovahkiinP dova){
+    Network *x = NULL;      /*Nodo actual*/
+    Network *y = NULL;      /*Vecino forward de 'x'*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'x'*/
+    u64 vflow;              /*Flujo del lado del arco actual*/
+    u64 i;                  /*Id del nodo actual*/
+    
+    assert(dova != NULL && dova->snap != NULL && dova->csr != NULL);
+    
+    network_index(dova);
+    for(i = 0; i < dova->n; i++)
+        dova->nodes[i]->nbrs = nbrhd_create(dova->arena);
+    for(i = 0; i < dova->n; i++){
+        x = dova->nodes[i];
+        end = nbrhd_arcEnd(dova->csr, i);
+        for(a = nbrhd_arcBegin(dova->csr, i); a < end; a++){
+            if (nbrhd_arcDir(dova->csr, i, a) == FWD){
+                y = dova->nodes[nbrhd_arcHead(dova->csr, a)];
+                nbrhd_addEdge(x->nbrs, y->nbrs, x->name, y->name, 
+                              nbrhd_arcCap(dova->csr, a));
+                vflow = nbrhd_arcResidual(dova->csr, 
+                                          nbrhd_arcPair(dova->csr, a));
+                if (vflow > 0)
+                    nbrhd_increaseFlow(x->nbrs, y->name, FWD, vflow);
             }
-        }else if(dir == BWD && !IS_SET_FLAG(SINK_REACHED))
-            getNbr = nbrhd_getBwd(x->nbrs, NXT, &yName);
+        }
+    }
+    dova_thaw(dova);
+    munmap(dova->snap, dova->snapLen);
+    dova->snap = NULL;
+    dova->snapLen = 0;
+}
+
+/** Fija en \p c la capacidad del lado 'xy' y repara el flujo si no entraba.
+ * Al flujo quitado al lado le falta salir de 'x' y llegar a 'y'. Primero se
+ * manda el exceso de 'x' hacia 'y', 's' o 't' y luego se trae a 'y' lo que le
+ * falte desde 's' o 't'; 's' y 't' no necesitan conservar flujo, así que con
+ * ellos no hace falta. El valor del flujo se recalcula con lo que sale de 's'.
+ * \param dova  El dova en el que se trabaja.
+ * \param x     El id del nodo 'x'.
+ * \param y     El id del nodo 'y'.
+ * \param arc   El arco FWD del lado 'xy'.
+ * \param c     Nueva capacidad del lado.
+ * \pre \p dova no es nulo, tiene una CSR armada y \p arc es el arco FWD del
+ *      lado 'xy'.
+ */
+static void dova_setCap(DovahkiinP dova, u64 x, u64 y, u64 arc, u64 c){
+    u64 cut;            /*Flujo que se le quitó al lado*/
+    u64 moved = 0;      /*Parte del exceso de 'x' que llegó a 'y'*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    cut = nbrhd_arcSetCap(dova->csr, arc, c);
+    gh_clear(dova);
+    if (dova->snap == NULL)
+        nbrhd_setCap(dova->nodes[x]->nbrs, dova->nodes[y]->name, c);
+    /*En un loop el exceso y el faltante se cancelan*/
+    if (cut > 0 && x != y){
+        if (x != dova->s && x != dova->t)
+            moved = repair_excess(dova, x, y, cut);
+        if (y != dova->s && y != dova->t && moved < cut)
+            repair_deficit(dova, y, cut - moved);
+        dova->flow = source_outflow(dova);
+    }
+    /*El corte y un camino encontrado antes quedaron sin sentido*/
+    UNSET_FLAG(MAXFLOW);
+    SET_FLAG(PATHUSED);
+}
+
+/** Manda \p e de exceso del nodo 'x' por caminos residuales hasta 'y', 's'
+ * o 't', el que quede más cerca, hasta que no quede exceso.
+ * A 's' solo se llega deshaciendo flujo que salió de ella, para que el valor
+ * del flujo no quede negativo.
+ * Cada camino se busca con un BFS desde 'x' que no pasa por los destinos, y
+ * solo recorre los nodos que visita: marca en 'live' (que queda limpio) y usa
+ * la pila del DFS como cola.
+ * \param dova  El dova en el que se trabaja.
+ * \param x     El id del nodo con exceso.
+ * \param y     El id del nodo al que le falta flujo.
+ * \param e     El exceso de 'x'.
+ * \pre \p dova no es nulo, tiene una CSR armada y el flujo era válido antes de
+ *      quitarle \p e al lado 'xy'.
+ * \return  Cuánto del exceso llegó a 'y'.
+ */
+static u64 repair_excess(DovahkiinP dova, u64 x, u64 y, u64 e){
+    u64 *q;                 /*Cola del BFS, sobre la pila del DFS*/
+    u64 head, tail;         /*Extremos de la cola*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'w'*/
+    u64 v, w;               /*Vecino por revisar y nodo que se expande*/
+    u64 found;              /*Destino alcanzado, o 'x' si no hay*/
+    u64 pflow;              /*Flujo que admite el camino*/
+    u64 moved = 0;          /*Exceso que llegó a 'y'. Retorno*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    q = dova->dfs;
+    while(e > 0){
+        head = tail = 0;
+        found = x;
+        dova->live[x] = true;
+        q[tail++] = x;
+        while(head < tail && found == x){
+            w = q[head++];
+            end = nbrhd_arcEnd(dova->csr, w);
+            for(a = nbrhd_arcBegin(dova->csr, w); a < end && found == x; a++){
+                v = nbrhd_arcHead(dova->csr, a);
+                /*A 's' solo se vuelve deshaciendo flujo que salió de ella*/
+                if(!dova->live[v] && nbrhd_arcResidual(dova->csr, a) > 0 &&
+                   (v != dova->s || nbrhd_arcDir(dova->csr, w, a) == BWD)){
+                    dova->live[v] = true;
+                    dova->pArc[v] = a;
+                    q[tail++] = v;
+                    if(v == y || v == dova->s || v == dova->t)
+                        found = v;
+                }
+            }
+        }
+        /*Dejo 'live' limpio para la próxima*/
+        while(tail > 0)
+            dova->live[q[--tail]] = false;
+        /*El flujo quitado venía de 's' y seguía a 't' (o a 'x' en un ciclo)*/
+        assert(found != x);
+        pflow = e;
+        for(v = found; v != x; v = nbrhd_arcHead(dova->csr, 
+                                      nbrhd_arcPair(dova->csr, dova->pArc[v])))
+            pflow = u64_min(pflow, nbrhd_arcResidual(dova->csr, dova->pArc[v]));
+        for(v = found; v != x; v = nbrhd_arcHead(dova->csr, 
+                                      nbrhd_arcPair(dova->csr, dova->pArc[v])))
+            nbrhd_arcPush(dova->csr, dova->pArc[v], pflow);
+        e -= pflow;
+        if(found == y)
+            moved += pflow;
+    }
+    return moved;
+}
+
+/** Trae \p e de flujo que le falta al nodo 'y' por caminos residuales desde
+ * 's' o 't', el que quede más cerca.
+ * Como repair_excess(), pero con el BFS hacia atrás desde 'y'. De 't' solo se
+ * trae flujo deshaciendo el que le llegó.
+ * \param dova  El dova en el que se trabaja.
+ * \param y     El id del nodo al que le falta flujo.
+ * \param e     El flujo que le falta a 'y'.
+ * \pre \p dova no es nulo, tiene una CSR armada y el flujo era válido antes de
+ *      quitarle \p e al lado que llega a 'y', con el exceso ya reparado.
+ */
+static void repair_deficit(DovahkiinP dova, u64 y, u64 e){
+    u64 *q;                 /*Cola del BFS, sobre la pila del DFS*/
+    u64 head, tail;         /*Extremos de la cola*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'w'*/
+    u64 b;                  /*Arco opuesto a 'a', de 'v' a 'w'*/
+    u64 v, w;               /*Vecino por revisar y nodo que se expande*/
+    u64 found;              /*Origen alcanzado, o 'y' si no hay*/
+    u64 pflow;              /*Flujo que admite el camino*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    q = dova->dfs;
+    while(e > 0){
+        head = tail = 0;
+        found = y;
+        dova->live[y] = true;
+        q[tail++] = y;
+        while(head < tail && found == y){
+            w = q[head++];
+            end = nbrhd_arcEnd(dova->csr, w);
+            for(a = nbrhd_arcBegin(dova->csr, w); a < end && found == y; a++){
+                v = nbrhd_arcHead(dova->csr, a);
+                /*El arco opuesto lleva de 'v' a 'w'. De 't' solo se trae
+                 flujo deshaciendo el que le llegó*/
+                b = nbrhd_arcPair(dova->csr, a);
+                if(!dova->live[v] && nbrhd_arcResidual(dova->csr, b) > 0 &&
+                   (v != dova->t || nbrhd_arcDir(dova->csr, v, b) == BWD)){
+                    dova->live[v] = true;
+                    dova->pArc[v] = b;
+                    q[tail++] = v;
+                    if(v == dova->s || v == dova->t)
+                        found = v;
+                }
+            }
+        }
+        while(tail > 0)
+            dova->live[q[--tail]] = false;
+        assert(found != y);
+        pflow = e;
+        for(v = found; v != y; v = nbrhd_arcHead(dova->csr, dova->pArc[v]))
+            pflow = u64_min(pflow, nbrhd_arcResidual(dova->csr, dova->pArc[v]));
+        for(v = found; v != y; v = nbrhd_arcHead(dova->csr, dova->pArc[v]))
+            nbrhd_arcPush(dova->csr, dova->pArc[v], pflow);
+        e -= pflow;
+    }
+}
+
+/** Calcula el valor del flujo como lo que sale de 's' menos lo que entra.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo y tiene una CSR armada.
+ * \return  El valor del flujo.
+ */
+static u64 source_outflow(DovahkiinP dova){
+    u64 a, end;         /*Arco actual y fin de los arcos de 's'*/
+    u64 out = 0;        /*Flujo que sale de 's'*/
+    u64 in = 0;         /*Flujo que entra a 's'*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    
+    end = nbrhd_arcEnd(dova->csr, dova->s);
+    for(a = nbrhd_arcBegin(dova->csr, dova->s); a < end; a++){
+        if(nbrhd_arcDir(dova->csr, dova->s, a) == FWD)
+            out += nbrhd_arcResidual(dova->csr, nbrhd_arcPair(dova->csr, a));
+        else
+            in += nbrhd_arcResidual(dova->csr, a);
+    }
+    assert(out >= in);
+    return out - in;
+}
+
+/** Descarta el árbol de Gomory-Hu, si se había calculado.
+ * \param dova  El dova en el que se trabaja.
+ * \pre \p dova no es nulo.
+ */
+static void gh_clear(DovahkiinP dova){
+    assert(dova != NULL);
+    if (dova->gh != NULL){
+        ghtree_destroy(dova->gh);
+        dova->gh = NULL;
+    }
+}
+
+/** Escribe en la salida del dova un lado con su valor, con el formato: \n
+ * \verbatim Lado x,y: <v> \endverbatim
+ * \param dova  El dova en el que se trabaja.
+ * \param x     Nombre del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \param v     Valor del lado (flujo, capacidad de corte, etc).
+ * \pre \p dova no es nulo.
+ */
+static void out_lado(DovahkiinP dova, u64 x, u64 y, u64 v){
+    assert(dova != NULL);
+    writer_str(dova->out, "Lado ");
+    writer_u64(dova->out, x);
+    writer_char(dova->out, ',');
+    writer_u64(dova->out, y);
+    writer_str(dova->out, ": ");
+    writer_u64(dova->out, v);
+    writer_char(dova->out, '\n');
+}
+
+/** Recorre los lados, en el orden de ImprimirFlujo(), sobre los arcos FWD de
+ * la CSR, escribiendo cada uno con su flujo.
+ * \note Los lados quitados con EliminarLado() siguen en la CSR, marcados en
+ * 'dead', y no se escriben.
+ * \param dova    El dova en el que se trabaja.
+ * \param W       Donde se escriben los lados, o NULL para solo contarlos.
+ * \param formato Formato del volcado, ver dump_edge().
+ * \pre \p dova no es nulo y tiene una CSR armada.
+ * \return  La cantidad de lados.
+ */
+static u64 dump_edges(DovahkiinP dova, Writer W, int formato){
+    u64 count = 0;      /*Cantidad de lados. Retorno*/
+    u64 xName, yName;   /*Nombres de los nodos del lado 'xy'*/
+    u64 vflow;          /*Flujo del lado 'xy'*/
+    u64 a, end;         /*Arco de 'x' y fin de sus arcos*/
+    u64 i;              /*Id del nodo 'x'*/
+    
+    assert(dova != NULL && dova->csr != NULL);
+    for(i = 0; i < dova->n; i++){
+        xName = dova->nodes[i]->name;
+        end = nbrhd_arcEnd(dova->csr, i);
+        for(a = nbrhd_arcBegin(dova->csr, i); a < end; a++){
+            if(nbrhd_arcDir(dova->csr, i, a) == FWD && !IS_DEAD(dova, a)){
+                count++;
+                if(W != NULL){
+                    /*El flujo del lado es el residuo de su arco BWD*/
+                    yName = dova->nodes[nbrhd_arcHead(dova->csr, a)]->name;
+                    vflow = nbrhd_arcResidual(dova->csr,
+                                              nbrhd_arcPair(dova->csr, a));
+                    dump_edge(W, formato, xName, yName, vflow);
+                }
+            }
+        }
+    }
+    return count;
+}
+
+/** Escribe un lado con su flujo en un volcado de VolcarFlujo().
+ * \param W       Donde se escribe el lado.
+ * \param formato VOLCADO_BIN (terna de u64 little-endian) o VOLCADO_CSV
+ *                (una linea "x,y,flujo").
+ * \param x       Nombre del nodo 'x'.
+ * \param y       Nombre del nodo 'y'.
+ * \param f       Flujo del lado 'xy'.
+ * \pre \p W no es nulo.
+ */
+static void dump_edge(Writer W, int formato, u64 x, u64 y, u64 f){
+    assert(W != NULL);
+    if(formato == VOLCADO_BIN){
+        writer_u64le(W, x);
+        writer_u64le(W, y);
+        writer_u64le(W, f);
+    }else{
+        writer_u64(W, x);
+        writer_char(W, ',');
+        writer_u64(W, y);
+        writer_char(W, ',');
+        writer_u64(W, f);
+        writer_char(W, '\n');
     }
 }
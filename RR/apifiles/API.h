@@ -15,6 +15,7 @@
 *               TADs
 */
 
+#include <stdio.h>
 #include "_u64.h"
 #include "lado.h"
 
@@ -22,6 +23,26 @@
  * Puntero al Dovahkiin. */
 typedef struct DovahkiinSt  *DovahkiinP;
 
+/** \struct Corte
+ * Corte minimal en arreglos, ver ObtenerCorte(). */
+typedef struct CorteSt{
+    u64 *nodos;     /**<Nombres de los nodos del corte, empezando por s.*/
+    u64 cantNodos;  /**<Cantidad de nodos del corte.*/
+    u64 *lados;     /**<Lados que salen del corte: ternas (x, y, capacidad).*/
+    u64 cantLados;  /**<Cantidad de lados (de ternas) que salen del corte.*/
+    u64 capacidad;  /**<Capacidad del corte.*/
+} Corte;
+
+/* Motores para calcular el flujo maximal, ver FijarMotor().*/
+#define MOTOR_DINIC 0   /**<Dinic: flujos bloqueantes por niveles.*/
+#define MOTOR_HL 1      /**<Push-relabel, descargando el nodo más alto.*/
+#define MOTOR_FIFO 2    /**<Push-relabel, descargando en orden FIFO.*/
+#define MOTOR_PAR 3     /**<Push-relabel sin locks, con varios hilos.*/
+
+/* Formatos de VolcarFlujo().*/
+#define VOLCADO_BIN 0   /**<Binario: u64 en orden little-endian.*/
+#define VOLCADO_CSV 1   /**<Texto con los valores separados por comas.*/
+
 
 /*
 *             Funciones
@@ -54,6 +75,43 @@ void FijarFuente(DovahkiinP dova, u64 x);
  */
 void FijarResumidero(DovahkiinP dova, u64 x);
 
+/* Establece la cantidad de hilos con los que se arman los niveles.
+ * Con al menos un hilo, ActualizarDistancias() usa un BFS sincronizado por
+ * niveles que reparte cada nivel entre los hilos y, cuando la frontera es
+ * grande, lo arma de abajo hacia arriba. Los niveles que se obtienen son los
+ * mismos que con el BFS de siempre, por lo que el flujo, los caminos y el
+ * corte no cambian.
+ * dova    El dova en el que se trabaja.
+ * threads Cantidad de hilos. 0 para volver al BFS de siempre.
+ * pre: dova debe ser un DovahkiinP no nulo.
+ */
+void FijarHilos(DovahkiinP dova, unsigned int threads);
+
+/* Activa o desactiva la poda del network de niveles.
+ * Con la poda activa, cada vez que ActualizarDistancias() alcanza 't' se hace
+ * un BFS hacia atrás desde 't' y se anula el nivel de los nodos que no están
+ * en ningún camino más corto de 's' a 't'. El DFS ya no entra en ellos, y los
+ * caminos que encuentra son los mismos.
+ * dova  El dova en el que se trabaja.
+ * on    1 para activar la poda, 0 para desactivarla.
+ * pre: dova debe ser un DovahkiinP no nulo.
+ */
+void FijarPoda(DovahkiinP dova, int on);
+
+/* Establece el motor con el que CalcularFlujoMaximal() calcula el flujo.
+ * Con MOTOR_DINIC (el de siempre) se alternan niveles y flujos bloqueantes.
+ * Con MOTOR_HL o MOTOR_FIFO se usa push-relabel, con global relabel y gap,
+ * que suele ser más rápido en networks densos o con mucho fan-in. Se obtiene
+ * el mismo valor de flujo, pero el flujo de cada lado puede ser otro.
+ * Con MOTOR_PAR se usa push-relabel en paralelo, con los hilos fijados con
+ * FijarHilos() (uno si no se fijaron). El flujo de cada lado puede cambiar de
+ * una corrida a otra.
+ * dova   El dova en el que se trabaja.
+ * motor  MOTOR_DINIC, MOTOR_HL, MOTOR_FIFO o MOTOR_PAR.
+ * pre: dova debe ser un DovahkiinP no nulo.
+ */
+void FijarMotor(DovahkiinP dova, int motor);
+
 /* Imprime por la salida estándar el nombre del nodo que es fuente.
  * Imprime por pantalla:
  * Fuente: s 
@@ -101,6 +159,145 @@ Lado LeerUnLado(void);
  */
 int CargarUnLado(DovahkiinP dova, Lado L);
 
+/* Carga en un DovahkiinP todos los lados de un archivo.
+ * Es equivalente a llamar a LeerUnLado() y CargarUnLado() hasta que no se 
+ * pueda cargar un lado: se aceptan las mismas lineas y se termina en la 
+ * primera que no es valida (o en el fin de archivo). Pero el archivo se lee de
+ * a bloques y se parsea sin crear un Lexer ni un Lado por linea.
+ * note: El archivo se lee por adelantado, por lo que puede quedar posicionado
+ * más allá de la linea en la que se terminó la carga.
+ * dova  El dova en el que se trabaja.
+ * f     El archivo abierto del que se leen los lados.
+ * pre: dova Debe ser un DovahkiinP no nulo y f un archivo abierto.
+ * return:  Cantidad de lados cargados.
+ */
+u64 CargarDesdeArchivo(DovahkiinP dova, FILE *f);
+
+/* Carga en un DovahkiinP todos los lados del archivo de ruta 'path'.
+ * Se aceptan las mismas lineas que en CargarDesdeArchivo(). Si el archivo es
+ * regular se mapea en memoria y se parsea directamente desde ahí, sin copiarlo
+ * a un buffer; si no (una tubería, una terminal) se lee de a bloques.
+ * dova  El dova en el que se trabaja.
+ * path  Ruta del archivo del que se leen los lados.
+ * pre: dova Debe ser un DovahkiinP no nulo y path no nulo.
+ * return:  1 si se pudo leer el archivo.
+ *          0 caso contrario.
+ */
+int CargarDesdeRuta(DovahkiinP dova, const char *path);
+
+/* Guarda el network de un DovahkiinP en un snapshot binario, que luego se
+ * carga con CargarSnapshot() sin volver a parsear los lados.
+ * El snapshot tiene los nombres de los nodos y la CSR con las capacidades, en
+ * el orden de la máquina. No guarda el flujo.
+ * note: Si la CSR no estaba armada, se arma aquí, como en Prepararse().
+ * dova  El dova en el que se trabaja.
+ * path  Ruta del archivo a escribir.
+ * pre: dova Debe ser un DovahkiinP no nulo y path no nulo.
+ * return:  1 si se pudo escribir el snapshot.
+ *          0 caso contrario.
+ */
+int GuardarSnapshot(DovahkiinP dova, const char *path);
+
+/* Carga en un DovahkiinP vacío el network de un snapshot escrito con
+ * GuardarSnapshot().
+ * El archivo se mapea en memoria y la CSR trabaja directamente sobre él, sin
+ * parsear ni armar las tablas hash de los nodos y sus vecinos. Queda listo
+ * para Prepararse() y los algoritmos, con flujo nulo.
+ * note: Si luego se carga un lado, los del snapshot se pasan primero a las
+ * vecindades, como si se hubieran cargado de a uno.
+ * dova  El dova en el que se trabaja.
+ * path  Ruta del snapshot.
+ * pre: dova Debe ser un DovahkiinP no nulo, sin lados cargados, y path no
+ *      nulo.
+ * return:  1 si se pudo cargar el snapshot.
+ *          0 si no se pudo leer o no es un snapshot.
+ */
+int CargarSnapshot(DovahkiinP dova, const char *path);
+
+/* Aumenta en 'c' la capacidad del lado 'xy', o lo agrega si no existe, sin
+ * perder el flujo que ya se calculó.
+ * El flujo sigue siendo válido, pero puede dejar de ser maximal: la próxima
+ * vuelta de ActualizarDistancias() (o CalcularFlujoMaximal()) sigue desde él,
+ * y si el cambio es chico termina en pocas fases. No hace falta volver a
+ * llamar a Prepararse().
+ * dova  El dova en el que se trabaja.
+ * x     Nombre del nodo 'x'.
+ * y     Nombre del nodo 'y'.
+ * c     Capacidad que se agrega al lado.
+ * pre: dova Debe ser un DovahkiinP no nulo.
+ */
+void AumentarCapacidad(DovahkiinP dova, u64 x, u64 y, u64 c);
+
+/* Baja en 'c' la capacidad del lado 'xy' (hasta 0), sin perder el flujo que
+ * ya se calculó. Si el flujo del lado no entra, se le quita lo que sobra y se
+ * repara el flujo cerca del lado: el exceso de 'x' se manda por caminos
+ * residuales hacia 'y', 's' o 't', y lo que le falte a 'y' se trae desde 's' o
+ * 't'. La próxima vuelta de ActualizarDistancias() reoptimiza desde ahí.
+ * dova  El dova en el que se trabaja.
+ * x     Nombre del nodo 'x'.
+ * y     Nombre del nodo 'y'.
+ * c     Capacidad que se le quita al lado.
+ * pre: dova Debe ser un DovahkiinP no nulo, preparado con Prepararse().
+ * return:  1 si el lado existe y se bajó su capacidad.
+ *          0 si el lado no existe.
+ */
+int DisminuirCapacidad(DovahkiinP dova, u64 x, u64 y, u64 c);
+
+/* Quita el lado 'xy' del network, reparando su flujo como
+ * DisminuirCapacidad() con toda su capacidad.
+ * dova  El dova en el que se trabaja.
+ * x     Nombre del nodo 'x'.
+ * y     Nombre del nodo 'y'.
+ * pre: dova Debe ser un DovahkiinP no nulo, preparado con Prepararse().
+ * return:  1 si el lado existía y se quitó.
+ *          0 si el lado no existe.
+ */
+int EliminarLado(DovahkiinP dova, u64 x, u64 y);
+
+/* Anula el flujo de todos los lados en una sola pasada, para volver a calcular
+ * sobre el mismo network (por ejemplo con otra fuente o resumidero) sin volver
+ * a cargarlo. Si la CSR está armada se conserva. El flujo deja de ser maximal.
+ * dova  El dova en el que se trabaja.
+ * pre: dova Debe ser un DovahkiinP no nulo.
+ */
+void ResetearFlujo(DovahkiinP dova);
+
+/* Calcula el árbol de Gomory-Hu del network tomado como no dirigido (un lado
+ * 'xy' de capacidad c permite enviar hasta c en cualquier sentido), con el que
+ * se conoce el corte minimal entre cualquier par de nodos. Se calculan n-1
+ * flujos maximales (método de Gusfield), tantos a la vez como hilos se fijaron
+ * con FijarHilos(). El flujo del dova no cambia. El árbol vale hasta que
+ * cambie el network.
+ * dova  El dova en el que se trabaja.
+ * pre: dova Debe ser un DovahkiinP no nulo.
+ */
+void CalcularArbolGomoryHu(DovahkiinP dova);
+
+/* Almacena en 'cut' la capacidad del corte minimal entre 'x' e 'y' del network
+ * tomado como no dirigido, recorriendo solo el camino entre ellos en el árbol
+ * de Gomory-Hu.
+ * dova  El dova en el que se trabaja.
+ * x     Nombre del nodo 'x'.
+ * y     Nombre del nodo 'y'.
+ * cut   Donde se almacena la capacidad del corte.
+ * pre: dova Debe ser un DovahkiinP no nulo, con el árbol calculado por
+ *      CalcularArbolGomoryHu(). 'cut' no es nulo.
+ * return:  1 si ambos nodos existen, son distintos, y se almacenó el corte.
+ *          0 caso contrario.
+ */
+int CorteMinimoEntre(DovahkiinP dova, u64 x, u64 y, u64 *cut);
+
+/* Imprime por Estandar Output el árbol de Gomory-Hu, con un lado por nodo
+ * (salvo la raíz) hacia su padre, en el orden en que se cargaron los nodos.
+ * Imprime con el formato:
+ * Arbol de Gomory-Hu:
+ * Lado x_1,y_2: <CorteMinimal>
+ * dova  El dova en el que se trabaja.
+ * pre: dova Debe ser un DovahkiinP no nulo, con el árbol calculado por
+ *      CalcularArbolGomoryHu().
+ */
+void ImprimirArbolGomoryHu(DovahkiinP dova);
+
 /* Preprocesa el DovahkiinP para empezar a buscar caminos aumentantes. 
  * Aqui se debe chequear y preparar todo lo que sea necesario para comenzar
  * a buscar caminos aumentantes. 
@@ -165,6 +362,31 @@ u64 AumentarFlujo(DovahkiinP dova);
  */
 u64 AumentarFlujoYTambienImprimirCamino(DovahkiinP dova);
 
+/* Calcula un flujo bloqueante sobre el network de niveles actual.
+ * Hace un único DFS desde 's' que, cada vez que llega a 't', envía por el
+ * camino el máximo flujo posible y retrocede hasta el primer arco que quedó
+ * saturado, para seguir avanzando desde ahí. Equivale a llamar a 
+ * BusquedaCaminoAumentante() y AumentarFlujo() hasta que no haya más caminos.
+ * dova  El dova en el que se trabaja.
+ * pre: dova Debe ser un DovahkiinP no nulo, preparado con Prepararse(), y la
+ *      última llamada a ActualizarDistancias() armó el network de niveles.
+ * return:  Valor del flujo bloqueante, que ya se sumó al flujo del network.
+ */
+u64 CalcularFlujoBloqueante(DovahkiinP dova);
+
+/* Calcula el flujo maximal del network con Dinic, de una sola vez.
+ * Alterna ActualizarDistancias() y CalcularFlujoBloqueante() hasta que no se
+ * alcance 't'. Si se eligió push-relabel con FijarMotor(), lo usa en su lugar
+ * y luego llama una vez a ActualizarDistancias() para armar el corte. Al
+ * terminar, el flujo es maximal y quedan armados el corte minimal y el flujo
+ * de cada lado, por lo que se pueden usar ImprimirFlujo(),
+ * ImprimirValorFlujo() e ImprimirCorte().
+ * dova  El dova en el que se trabaja.
+ * pre: dova Debe ser un DovahkiinP no nulo, preparado con Prepararse().
+ * return:  Valor del flujo maximal.
+ */
+u64 CalcularFlujoMaximal(DovahkiinP dova);
+
 /* Imprime por Estandar Output el Flujo hasta el momento. 
  * Imprime con el formato: 
  * Flujo �:
@@ -199,4 +421,51 @@ void ImprimirValorFlujo(DovahkiinP dova);
  */  
 void ImprimirCorte(DovahkiinP dova);
 
+/* Devuelve el corte minimal en arreglos, para usarlo sin leer la salida de
+ * ImprimirCorte(): los nombres de los nodos del corte, empezando por 's' y en
+ * el orden en que se alcanzaron, y los lados que salen del corte (incluso los
+ * de capacidad 0, no los quitados con EliminarLado()), como ternas (x, y,
+ * capacidad) seguidas, junto con la capacidad del corte. Los arreglos se
+ * liberan con LiberarCorte().
+ * dova  El dova en el que se trabaja.
+ * corte Donde se almacena el corte.
+ * pre: dova Debe ser un DovahkiinP no nulo y corte no nulo.
+ * return:  1 si hay corte minimal (se llegó a flujo maximal) y se almacenó.
+ *          0 caso contrario, y corte queda vacío.
+ */
+int ObtenerCorte(DovahkiinP dova, Corte *corte);
+
+/* Libera los arreglos de un corte obtenido con ObtenerCorte().
+ * corte El corte a liberar.
+ * pre: corte no es nulo.
+ */
+void LiberarCorte(Corte *corte);
+
+/* Escribe en el archivo 'path' el flujo de cada lado, para que lo lean otros
+ * programas sin parsear la salida de ImprimirFlujo(). Se escribe el valor del
+ * flujo y si es maximal, los lados (salvo los quitados con EliminarLado()) en
+ * el mismo orden que ImprimirFlujo(), y si el flujo es maximal los nombres de
+ * los nodos del corte, empezando por s.
+ * Con VOLCADO_BIN todo son u64 little-endian: un encabezado de 5 (el número
+ * mágico "DOVAFLW1", el valor del flujo, 1 si es maximal o 0 si no, la
+ * cantidad de lados y la de nodos del corte), una terna (x, y, flujo) por
+ * lado y un nombre por nodo del corte.
+ * Con VOLCADO_CSV se escribe:
+ * valor,maximal
+ * <ValorDelFlujo>,<1 o 0>
+ * x,y,flujo
+ * x_1,y_1,<FlujoDelLado>
+ * corte
+ * <Fuente>
+ * x_1
+ * donde la sección del corte solo está si el flujo es maximal.
+ * dova    El dova en el que se trabaja.
+ * path    Ruta del archivo a escribir.
+ * formato VOLCADO_BIN o VOLCADO_CSV.
+ * pre: dova Debe ser un DovahkiinP no nulo y path no nulo.
+ * return:  1 si se escribió el archivo.
+ *          0 si no se pudo escribir.
+ */
+int VolcarFlujo(DovahkiinP dova, const char *path, int formato);
+
 #endif
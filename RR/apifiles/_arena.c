@@ -0,0 +1,113 @@
+﻿#include <assert.h>
+#include <stdlib.h>
+#include "_arena.h"
+
+#define ARENA_BLOCK (1 << 20)   /**<Tamaño de un bloque de la arena.*/
+#define ARENA_ALIGN 16          /**<Alineación de cada pedido.*/
+
+/** Redondea 'n' hacia arriba al múltiplo de ARENA_ALIGN.*/
+#define ALIGN_UP(n) (((n) + ARENA_ALIGN - 1) & ~((size_t)ARENA_ALIGN - 1))
+
+/** Estructura de un bloque de memoria de la arena.
+ * Los bloques se encadenan del más nuevo al más viejo. La memoria que se 
+ * reparte empieza en 'data'.
+ */
+typedef struct ABlockSt{
+    struct ABlockSt *next;  /**<Bloque pedido antes que este.*/
+    size_t size;            /**<Bytes disponibles en 'data'.*/
+    size_t used;            /**<Bytes ya repartidos de 'data'.*/
+    union{
+        long double ld;     /**<Fuerza la alineación de 'data'.*/
+        void *p;
+        unsigned long long u;
+    } data[1];              /**<Comienzo de la memoria del bloque.*/
+} ABlock;
+
+/** Estructura principal de una arena.*/
+struct ArenaSt{
+    ABlock *top;    /**<Bloque actual, del que se sirven los pedidos.*/
+};
+
+static ABlock *ablock_create(size_t size, ABlock *next);
+
+
+/** Crea una arena vacía.
+ * \return Un puntero a la arena creada.
+*/
+Arena arena_create(void){
+    Arena A = NULL;     /*La nueva arena*/
+    
+    A = (Arena) malloc(sizeof(struct ArenaSt));
+    assert(A != NULL);
+    A->top = NULL;
+    return A;
+}
+
+/** Destruye la arena A y libera toda la memoria que se pidió de ella.
+ * Cualquier elemento que se haya pedido a la arena deja de ser valido.
+ * \param A La arena a destruir.
+ * \pre La arena A no es nula.
+ */
+void arena_destroy(Arena A){
+    ABlock *block = NULL;   /*Bloque a liberar*/
+    
+    assert(A != NULL);
+    while(A->top != NULL){
+        block = A->top;
+        A->top = block->next;
+        free(block);
+    }
+    free(A);
+}
+
+/** Pide memoria para un elemento de 'size' bytes.
+ * La memoria devuelta esta alineada para cualquier tipo de la librería y no
+ * se inicializa. El llamador no debe liberarla.
+ * \note Si el pedido no entra en lo que queda del bloque actual se empieza uno
+ * nuevo. Un pedido más grande que un bloque recibe un bloque propio, que se 
+ * encadena detrás del actual para seguir usando lo que queda de este.
+ * \param A La arena de la que se pide la memoria.
+ * \param size Cantidad de bytes que se piden.
+ * \pre La arena A no es nula.
+ * \return Un puntero a la memoria pedida.
+ */
+void *arena_alloc(Arena A, size_t size){
+    ABlock *block = NULL;   /*Bloque del que se sirve el pedido*/
+    void *result = NULL;    /*La memoria pedida*/
+    
+    assert(A != NULL);
+    size = ALIGN_UP(size);
+    if(size > ARENA_BLOCK / 4){
+        /*Pedido grande: bloque propio*/
+        block = ablock_create(size, NULL);
+        if(A->top != NULL){
+            block->next = A->top->next;
+            A->top->next = block;
+        }else
+            A->top = block;
+    }else{
+        if(A->top == NULL || A->top->size - A->top->used < size)
+            A->top = ablock_create(ARENA_BLOCK, A->top);
+        block = A->top;
+    }
+    result = (char*)block->data + block->used;
+    block->used += size;
+    return result;
+}
+
+
+/** Crea un bloque de la arena con 'size' bytes disponibles.
+ * \param size Bytes disponibles del bloque.
+ * \param next Bloque al que se encadena.
+ * \return El nuevo bloque, sin memoria repartida.
+ */
+static ABlock *ablock_create(size_t size, ABlock *next){
+    ABlock *block = NULL;   /*El nuevo bloque*/
+    
+    block = (ABlock*) malloc(sizeof(ABlock) + size);
+    assert(block != NULL);
+    block->next = next;
+    block->size = size;
+    block->used = 0;
+    return block;
+}
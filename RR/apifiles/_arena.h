@@ -0,0 +1,41 @@
+﻿#ifndef ARENA_H
+#define ARENA_H
+
+#include <stddef.h>
+
+/** \file _arena.h
+ * La librería _arena proporciona una región de memoria de la que se piden
+ * muchos elementos chicos que viven lo mismo que ella. Los pedidos se sirven
+ * de bloques grandes, consecutivamente, y no se liberan de a uno: toda la
+ * memoria se devuelve junta al destruir la arena. Esto ahorra el costo de un
+ * malloc y un free por cada elemento, y el espacio extra que cada uno ocupa.
+*/
+
+/** \struct Arena
+ * Puntero a una arena.
+ */
+typedef struct ArenaSt *Arena;
+
+/* Crea una arena vacía.
+ * return: Un puntero a la arena creada.
+*/
+Arena arena_create(void);
+
+/* Destruye la arena A y libera toda la memoria que se pidió de ella.
+ * Cualquier elemento que se haya pedido a la arena deja de ser valido.
+ * A La arena a destruir.
+ * pre: La arena A no es nula.
+ */
+void arena_destroy(Arena A);
+
+/* Pide memoria para un elemento de 'size' bytes.
+ * La memoria devuelta esta alineada para cualquier tipo de la librería y no
+ * se inicializa. El llamador no debe liberarla.
+ * A La arena de la que se pide la memoria.
+ * size Cantidad de bytes que se piden.
+ * pre: La arena A no es nula.
+ * return: Un puntero a la memoria pedida.
+ */
+void *arena_alloc(Arena A, size_t size);
+
+#endif
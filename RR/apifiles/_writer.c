@@ -0,0 +1,191 @@
+﻿#define _POSIX_C_SOURCE 200809L   /*write*/
+
+#include <assert.h>
+#include <errno.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include "_writer.h"
+
+#define WRITER_BUFFER (1 << 16) /**<Tamaño del buffer de un writer.*/
+#define U64_DIGITS 20           /**<Cifras decimales del mayor u64.*/
+
+/** Estructura principal de un writer.*/
+struct WriterSt{
+    int fd;         /**<File descriptor de salida, si 'f' es nulo.*/
+    FILE *f;        /**<FILE de salida. NULL si se vuelca sobre 'fd'.*/
+    char *buf;      /**<Buffer de lo escrito que falta volcar.*/
+    size_t len;     /**<Bytes ocupados de 'buf'.*/
+    bool ok;        /**<Todos los volcados anteriores se completaron.*/
+};
+
+static Writer writer_new(int fd, FILE *f);
+
+
+/** Crea un writer que vuelca sobre el file descriptor 'fd'.
+ * \param fd El file descriptor, abierto para escritura. El writer no lo
+ *           cierra.
+ * \return Un puntero al writer creado.
+*/
+Writer writer_create(int fd){
+    return writer_new(fd, NULL);
+}
+
+/** Crea un writer que vuelca sobre el FILE 'f'.
+ * \param f El FILE, abierto para escritura. El writer no lo cierra.
+ * \pre f no es nulo.
+ * \return Un puntero al writer creado.
+*/
+Writer writer_createFile(FILE *f){
+    assert(f != NULL);
+    return writer_new(-1, f);
+}
+
+/** Vuelca lo que quede en el buffer y destruye el writer W.
+ * \param W El writer a destruir.
+ * \pre El writer W no es nulo.
+ */
+void writer_destroy(Writer W){
+    assert(W != NULL);
+    writer_flush(W);
+    free(W->buf);
+    free(W);
+}
+
+/** Vuelca lo que haya en el buffer de W a su salida.
+ * \note Sobre un file descriptor se reintenta hasta escribir todo, salvo que
+ * falle; lo que no se pudo escribir se descarta.
+ * \param W El writer.
+ * \pre El writer W no es nulo.
+ * \return true si todo lo escrito hasta ahora llegó a la salida. false si
+ *         alguna escritura falló.
+ */
+bool writer_flush(Writer W){
+    size_t done = 0;    /*Bytes del buffer ya volcados*/
+    ssize_t k;          /*Bytes volcados por una llamada a write*/
+    
+    assert(W != NULL);
+    if(W->f != NULL){
+        if(W->len > 0 && fwrite(W->buf, 1, W->len, W->f) != W->len)
+            W->ok = false;
+    }else{
+        while(done < W->len){
+            k = write(W->fd, W->buf + done, W->len - done);
+            if(k > 0)
+                done += (size_t) k;
+            else if(k < 0 && errno != EINTR){
+                W->ok = false;
+                break;
+            }
+        }
+    }
+    W->len = 0;
+    return W->ok;
+}
+
+/** Escribe los 'n' bytes de 'data', tal cual.
+ * Lo que no entra en el buffer se copia a medida que se vuelca.
+ * \param W El writer.
+ * \param data Los bytes a escribir.
+ * \param n Cantidad de bytes.
+ * \pre El writer W no es nulo, y data no es nulo si n > 0.
+ */
+void writer_bytes(Writer W, const void *data, size_t n){
+    const char *p = data;   /*Bytes que faltan copiar*/
+    size_t k;               /*Bytes que se copian en esta vuelta*/
+    
+    assert(W != NULL && (data != NULL || n == 0));
+    while(n > 0){
+        if(W->len == WRITER_BUFFER)
+            writer_flush(W);
+        k = WRITER_BUFFER - W->len;
+        if(k > n)
+            k = n;
+        memcpy(W->buf + W->len, p, k);
+        W->len += k;
+        p += k;
+        n -= k;
+    }
+}
+
+/** Escribe la cadena 's', sin el '\0' final.
+ * \param W El writer.
+ * \param s La cadena.
+ * \pre El writer W no es nulo, y s no es nulo.
+ */
+void writer_str(Writer W, const char *s){
+    assert(W != NULL && s != NULL);
+    writer_bytes(W, s, strlen(s));
+}
+
+/** Escribe el caracter 'c'.
+ * \param W El writer.
+ * \param c El caracter.
+ * \pre El writer W no es nulo.
+ */
+void writer_char(Writer W, char c){
+    assert(W != NULL);
+    if(W->len == WRITER_BUFFER)
+        writer_flush(W);
+    W->buf[W->len++] = c;
+}
+
+/** Escribe 'n' en decimal, igual que printf("%"PRIu64, n).
+ * Las cifras se arman de la menos significativa a la más, al final de un
+ * arreglo local, y se copian juntas.
+ * \param W El writer.
+ * \param n El número.
+ * \pre El writer W no es nulo.
+ */
+void writer_u64(Writer W, u64 n){
+    char digits[U64_DIGITS];    /*Cifras de 'n', al final del arreglo*/
+    size_t i = U64_DIGITS;      /*Posición de la cifra más significativa*/
+    
+    assert(W != NULL);
+    do{
+        digits[--i] = (char)('0' + n % 10);
+        n /= 10;
+    }while(n > 0);
+    if(WRITER_BUFFER - W->len < U64_DIGITS)
+        writer_flush(W);
+    memcpy(W->buf + W->len, digits + i, U64_DIGITS - i);
+    W->len += U64_DIGITS - i;
+}
+
+/** Escribe 'n' en binario, como 8 bytes en orden little-endian, sin importar
+ * el orden de la máquina.
+ * \param W El writer.
+ * \param n El número.
+ * \pre El writer W no es nulo.
+ */
+void writer_u64le(Writer W, u64 n){
+    size_t i;   /*Byte actual, del menos significativo al más*/
+    
+    assert(W != NULL);
+    if(WRITER_BUFFER - W->len < sizeof(u64))
+        writer_flush(W);
+    for(i = 0; i < sizeof(u64); i++){
+        W->buf[W->len++] = (char)(n & 0xff);
+        n >>= 8;
+    }
+}
+
+
+/** Crea un writer con el buffer vacío.
+ * \param fd File descriptor de salida, si 'f' es nulo.
+ * \param f  FILE de salida, o NULL.
+ * \return El nuevo writer.
+ */
+static Writer writer_new(int fd, FILE *f){
+    Writer W = NULL;    /*El nuevo writer*/
+    
+    W = (Writer) malloc(sizeof(struct WriterSt));
+    assert(W != NULL);
+    W->buf = (char*) malloc(WRITER_BUFFER);
+    assert(W->buf != NULL);
+    W->fd = fd;
+    W->f = f;
+    W->len = 0;
+    W->ok = true;
+    return W;
+}
@@ -0,0 +1,87 @@
+﻿#ifndef WRITER_H
+#define WRITER_H
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "_u64.h"
+
+/** \file _writer.h
+ * La librería _writer proporciona una salida con un buffer grande propio, para
+ * escribir mucho texto (o datos binarios) sin pasar por printf. Los números se
+ * convierten a decimal a mano y todo se copia al buffer, que se vuelca de una
+ * sola vez cuando se llena o cuando se pide. La salida puede ser un file
+ * descriptor o un FILE de stdio; en el segundo caso el volcado pasa por el
+ * FILE, y así respeta el orden con lo que se haya escrito en él con printf.
+*/
+
+/** \struct Writer
+ * Puntero a un writer.
+ */
+typedef struct WriterSt *Writer;
+
+/* Crea un writer que vuelca sobre el file descriptor 'fd'.
+ * fd El file descriptor, abierto para escritura. El writer no lo cierra.
+ * return: Un puntero al writer creado.
+*/
+Writer writer_create(int fd);
+
+/* Crea un writer que vuelca sobre el FILE 'f'.
+ * f El FILE, abierto para escritura. El writer no lo cierra.
+ * pre: f no es nulo.
+ * return: Un puntero al writer creado.
+*/
+Writer writer_createFile(FILE *f);
+
+/* Vuelca lo que quede en el buffer y destruye el writer W.
+ * W El writer a destruir.
+ * pre: El writer W no es nulo.
+ */
+void writer_destroy(Writer W);
+
+/* Vuelca lo que haya en el buffer de W a su salida.
+ * W El writer.
+ * pre: El writer W no es nulo.
+ * return: true si todo lo escrito hasta ahora llegó a la salida. false si
+ *         alguna escritura falló.
+ */
+bool writer_flush(Writer W);
+
+/* Escribe los 'n' bytes de 'data', tal cual.
+ * W El writer.
+ * data Los bytes a escribir.
+ * n Cantidad de bytes.
+ * pre: El writer W no es nulo, y data no es nulo si n > 0.
+ */
+void writer_bytes(Writer W, const void *data, size_t n);
+
+/* Escribe la cadena 's', sin el '\0' final.
+ * W El writer.
+ * s La cadena.
+ * pre: El writer W no es nulo, y s no es nulo.
+ */
+void writer_str(Writer W, const char *s);
+
+/* Escribe el caracter 'c'.
+ * W El writer.
+ * c El caracter.
+ * pre: El writer W no es nulo.
+ */
+void writer_char(Writer W, char c);
+
+/* Escribe 'n' en decimal, igual que printf("%"PRIu64, n).
+ * W El writer.
+ * n El número.
+ * pre: El writer W no es nulo.
+ */
+void writer_u64(Writer W, u64 n);
+
+/* Escribe 'n' en binario, como 8 bytes en orden little-endian, sin importar
+ * el orden de la máquina.
+ * W El writer.
+ * n El número.
+ * pre: El writer W no es nulo.
+ */
+void writer_u64le(Writer W, u64 n);
+
+#endif
@@ -0,0 +1,502 @@
+﻿#define _POSIX_C_SOURCE 200809L   /*pthread_barrier_t*/
+
+#include <assert.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "bfs.h"
+
+#define LVL_NIL -1          /**<Distancia nula de un nodo.*/
+#define BFS_CHUNK 64        /**<Nodos de la frontera que un hilo toma por vez.*/
+#define BFS_WORDS 16        /**<Palabras de un bitmap que un hilo toma por vez
+                            en un paso de abajo hacia arriba.*/
+#define BFS_LINE 64         /**<Tamaño de una linea de cache.*/
+#define BFS_ALPHA 14        /**<Se pasa de arriba hacia abajo a abajo hacia
+                            arriba si los arcos de la frontera superan a los de
+                            los nodos sin visitar divididos BFS_ALPHA.*/
+#define BFS_BETA 24         /**<Se vuelve de abajo hacia arriba a arriba hacia
+                            abajo si la frontera tiene menos de n/BFS_BETA
+                            nodos.*/
+
+/** Palabra de un bitmap en la que está el bit del nodo 'x'.*/
+#define WORD(x) ((x) >> 6)
+/** Máscara del bit del nodo 'x' en su palabra.*/
+#define BIT(x) ((u64) 1 << ((x) & 63))
+
+/** Datos propios de cada hilo.
+ * Se rellena hasta ocupar una linea de cache, para que los hilos no se pisen
+ * las lineas al escribir cada uno en los suyos.
+ */
+typedef struct BfsWorkerSt{
+    Bfs bfs;            /**<El buscador del que es parte el hilo.*/
+    unsigned int k;     /**<Índice del hilo. El 0 es el que llama a bfs_run().*/
+    u64 *buf;           /**<Nodos que el hilo agregó a la frontera siguiente.*/
+    u64 len;            /**<Cantidad de nodos en 'buf'.*/
+    u64 size;           /**<Capacidad de 'buf'.*/
+    u64 deg;            /**<Suma de los arcos de los nodos de 'buf'.*/
+    char pad[BFS_LINE];
+} BfsWorker;
+
+/** Estructura principal de un buscador.
+ * Los datos de la búsqueda en curso los escribe el hilo 0 antes de la barrera
+ * de inicio y los demás hilos solo los leen.
+ * Cada nivel se arma de una de dos formas. De arriba hacia abajo, los nodos
+ * de la frontera reclaman a sus vecinos sin visitar. De abajo hacia arriba,
+ * cada nodo sin visitar busca un arco con residuo que le llegue desde la
+ * frontera, y deja de buscar apenas lo encuentra; conviene cuando la frontera
+ * es grande y casi todos los vecinos que revisaría ya están visitados. Para
+ * eso los visitados y la frontera se guardan en bitmaps, de un bit por nodo.
+ */
+struct BfsSt{
+    unsigned int threads;       /**<Cantidad de hilos.*/
+    pthread_t *tid;             /**<Hilos lanzados, del 1 al threads-1.*/
+    pthread_barrier_t start;    /**<Espera de una nueva búsqueda.*/
+    pthread_barrier_t step;     /**<Sincronización entre niveles.*/
+    BfsWorker *w;               /**<Datos de cada hilo.*/
+    bool quit;                  /**<Los hilos deben terminar.*/
+    /*Búsqueda en curso*/
+    NbrhdCsr csr;               /**<CSR del network.*/
+    int *lvl;                   /**<Distancias de los nodos.*/
+    u64 t;                      /**<Id del nodo que termina la búsqueda.*/
+    bool reverse;               /**<Se recorren los arcos hacia atrás.*/
+    u64 *front;                 /**<Frontera del nivel actual.*/
+    u64 *next;                  /**<Frontera del nivel siguiente.*/
+    u64 size;                   /**<Capacidad de 'front' y 'next'.*/
+    u64 *visited;               /**<Bitmap de los nodos con distancia.*/
+    u64 *fbits[2];              /**<Bitmaps de la frontera, para los niveles
+                                pares e impares. Vacíos fuera de un paso de
+                                abajo hacia arriba.*/
+    u64 n;                      /**<Cantidad de nodos.*/
+    u64 words;                  /**<Palabras de cada bitmap.*/
+    u64 mu;                     /**<Arcos de los nodos sin visitar.*/
+    u64 frontLen;               /**<Cantidad de nodos en 'front'.*/
+    u64 pos[2];                 /**<Próximo bloque de la frontera por tomar,
+                                para los niveles pares e impares.*/
+    bool reached;               /**<Se alcanzó 't'.*/
+};
+
+static void bfs_start(Bfs bfs, NbrhdCsr csr, u64 n, int *lvl, u64 root, 
+                      u64 stop, u64 skip, bool reverse);
+static void *bfs_worker(void *arg);
+static void bfs_search(BfsWorker *w);
+static void bfs_topDown(BfsWorker *w, const u64 *front, u64 frontLen,
+                        unsigned int par, int l);
+static void bfs_bottomUp(BfsWorker *w, unsigned int par, int l);
+static void bfs_expand(BfsWorker *w, u64 x, int l);
+static void bfs_adopt(BfsWorker *w, u64 v, const u64 *fbits, int l);
+static void bfs_push(BfsWorker *w, u64 y);
+
+
+/** Crea un buscador que trabaja con \p threads hilos.
+ * El hilo que llama a bfs_run() es uno de ellos: se lanzan \p threads-1 hilos
+ * que esperan hasta que haya una búsqueda para hacer.
+ * \param threads Cantidad de hilos.
+ * \pre threads > 0.
+ * \return Un nuevo Bfs. El llamador se encarga de destruirlo.
+ */
+Bfs bfs_create(unsigned int threads){
+    Bfs bfs = NULL;     /*El nuevo buscador*/
+    unsigned int k;     /*Índice de hilo*/
+    int err;            /*Error de pthread*/
+    
+    assert(threads > 0);
+    bfs = (Bfs) malloc(sizeof(struct BfsSt));
+    assert(bfs != NULL);
+    bfs->threads = threads;
+    bfs->tid = (pthread_t*) malloc(threads * sizeof(pthread_t));
+    bfs->w = (BfsWorker*) malloc(threads * sizeof(BfsWorker));
+    assert(bfs->tid != NULL && bfs->w != NULL);
+    bfs->quit = false;
+    bfs->csr = NULL;
+    bfs->lvl = NULL;
+    bfs->front = NULL;
+    bfs->next = NULL;
+    bfs->size = 0;
+    bfs->visited = NULL;
+    bfs->fbits[0] = NULL;
+    bfs->fbits[1] = NULL;
+    err = pthread_barrier_init(&bfs->start, NULL, threads);
+    assert(err == 0);
+    err = pthread_barrier_init(&bfs->step, NULL, threads);
+    assert(err == 0);
+    
+    for(k = 0; k < threads; k++){
+        bfs->w[k].bfs = bfs;
+        bfs->w[k].k = k;
+        bfs->w[k].buf = NULL;
+        bfs->w[k].len = 0;
+        bfs->w[k].size = 0;
+        bfs->w[k].deg = 0;
+    }
+    for(k = 1; k < threads; k++){
+        err = pthread_create(&bfs->tid[k], NULL, bfs_worker, &bfs->w[k]);
+        assert(err == 0);
+    }
+    (void) err;
+    return bfs;
+}
+
+/** Destructor de un Bfs. Termina sus hilos.
+ * \param bfs El buscador a destruir.
+ * \pre \p bfs no es nulo y no hay una búsqueda en curso.
+ */
+void bfs_destroy(Bfs bfs){
+    unsigned int k;     /*Índice de hilo*/
+    
+    assert(bfs != NULL);
+    /*Los hilos esperan en la barrera de inicio y al pasarla ven 'quit'*/
+    bfs->quit = true;
+    pthread_barrier_wait(&bfs->start);
+    for(k = 1; k < bfs->threads; k++)
+        pthread_join(bfs->tid[k], NULL);
+    
+    for(k = 0; k < bfs->threads; k++)
+        free(bfs->w[k].buf);
+    pthread_barrier_destroy(&bfs->start);
+    pthread_barrier_destroy(&bfs->step);
+    free(bfs->front);
+    free(bfs->next);
+    free(bfs->visited);
+    free(bfs->fbits[0]);
+    free(bfs->fbits[1]);
+    free(bfs->w);
+    free(bfs->tid);
+    free(bfs);
+}
+
+/** Cantidad de hilos con los que trabaja el buscador.
+ * \param bfs El buscador.
+ * \pre \p bfs no es nulo.
+ */
+unsigned int bfs_threads(Bfs bfs){
+    assert(bfs != NULL);
+    return bfs->threads;
+}
+
+/** Asigna a cada nodo su distancia desde 's' por arcos con residuo positivo.
+ * La búsqueda termina al completar el nivel en el que se alcanza 't' (en ese
+ * nivel puede quedar algún nodo sin su distancia) o al acabarse los nodos.
+ * \param bfs   El buscador.
+ * \param csr   La CSR del network.
+ * \param n     Cantidad de nodos de \p csr.
+ * \param lvl   Arreglo de \p n distancias. Las no asignadas valen -1.
+ * \param s     Id del nodo fuente.
+ * \param t     Id del nodo resumidero.
+ * \pre \p bfs, \p csr y \p lvl no son nulos. lvl[i] == -1 para todo nodo 'i'.
+ *      \p s y \p t son ids validos.
+ * \return true si se alcanzó \p t.\n
+ *         false caso contrario.
+ */
+bool bfs_run(Bfs bfs, NbrhdCsr csr, u64 n, int *lvl, u64 s, u64 t){
+    assert(bfs != NULL && csr != NULL && lvl != NULL);
+    assert(s < n && t < n);
+    
+    bfs_start(bfs, csr, n, lvl, s, t, n, false);
+    return bfs->reached;
+}
+
+/** Asigna a cada nodo su distancia hasta 't' por arcos con residuo positivo,
+ * sin pasar por 's'.
+ * Es el mismo BFS que bfs_run(), pero hacia atrás desde 't' y sin cortar: los
+ * nodos que no llegan a 't', y 's', quedan sin distancia.
+ * \param bfs   El buscador.
+ * \param csr   La CSR del network.
+ * \param n     Cantidad de nodos de \p csr.
+ * \param lvl   Arreglo de \p n distancias. Las no asignadas valen -1.
+ * \param t     Id del nodo resumidero.
+ * \param s     Id del nodo fuente.
+ * \pre \p bfs, \p csr y \p lvl no son nulos. lvl[i] == -1 para todo nodo 'i'.
+ *      \p s y \p t son ids validos y distintos.
+ */
+void bfs_toSink(Bfs bfs, NbrhdCsr csr, u64 n, int *lvl, u64 t, u64 s){
+    assert(bfs != NULL && csr != NULL && lvl != NULL);
+    assert(s < n && t < n && s != t);
+    
+    bfs_start(bfs, csr, n, lvl, t, n, s, true);
+}
+
+/** Prepara y hace una búsqueda con todos los hilos.
+ * \param bfs     El buscador.
+ * \param csr     La CSR del network.
+ * \param n       Cantidad de nodos de \p csr.
+ * \param lvl     Arreglo de \p n distancias, todas -1.
+ * \param root    Id del nodo de nivel 0.
+ * \param stop    Id del nodo que, al alcanzarse, termina la búsqueda. \p n
+ *                para no terminar antes.
+ * \param skip    Id de un nodo que no se visita. \p n para ninguno.
+ * \param reverse Se recorren los arcos hacia atrás: se llega a 'x' desde 'y'
+ *                si hay residuo de 'x' a 'y'.
+ */
+static void bfs_start(Bfs bfs, NbrhdCsr csr, u64 n, int *lvl, u64 root, 
+                      u64 stop, u64 skip, bool reverse){
+    u64 i;      /*Palabra de los bitmaps*/
+    
+    bfs->n = n;
+    bfs->words = WORD(n + 63);
+    /*Cada nodo entra una sola vez a una frontera*/
+    if (bfs->size < n){
+        free(bfs->front);
+        free(bfs->next);
+        free(bfs->visited);
+        free(bfs->fbits[0]);
+        free(bfs->fbits[1]);
+        bfs->front = (u64*) malloc(n * sizeof(u64));
+        bfs->next = (u64*) malloc(n * sizeof(u64));
+        bfs->visited = (u64*) malloc(bfs->words * sizeof(u64));
+        bfs->fbits[0] = (u64*) calloc(bfs->words, sizeof(u64));
+        bfs->fbits[1] = (u64*) calloc(bfs->words, sizeof(u64));
+        assert(bfs->front != NULL && bfs->next != NULL);
+        assert(bfs->visited != NULL);
+        assert(bfs->fbits[0] != NULL && bfs->fbits[1] != NULL);
+        bfs->size = n;
+    }
+    for(i = 0; i < bfs->words; i++)
+        bfs->visited[i] = 0;
+    bfs->csr = csr;
+    bfs->lvl = lvl;
+    bfs->t = stop;
+    bfs->reverse = reverse;
+    bfs->reached = false;
+    bfs->pos[0] = 0;
+    bfs->pos[1] = 0;
+    bfs->mu = nbrhd_arcEnd(csr, n - 1) -
+              (nbrhd_arcEnd(csr, root) - nbrhd_arcBegin(csr, root));
+    /*El nodo salteado se marca como visitado, pero sin nivel*/
+    if (skip < n){
+        bfs->visited[WORD(skip)] |= BIT(skip);
+        bfs->mu -= nbrhd_arcEnd(csr, skip) - nbrhd_arcBegin(csr, skip);
+    }
+    /*La raíz es nivel 0*/
+    lvl[root] = 0;
+    bfs->visited[WORD(root)] |= BIT(root);
+    bfs->front[0] = root;
+    bfs->frontLen = 1;
+    
+    pthread_barrier_wait(&bfs->start);
+    bfs_search(&bfs->w[0]);
+}
+
+/** Cuerpo de los hilos lanzados: hace cada búsqueda hasta que se pida 'quit'.
+ * \param arg Los datos del hilo (BfsWorker*).
+ */
+static void *bfs_worker(void *arg){
+    BfsWorker *w = (BfsWorker*) arg;    /*Datos del hilo*/
+    
+    pthread_barrier_wait(&w->bfs->start);
+    while(!w->bfs->quit){
+        bfs_search(w);
+        pthread_barrier_wait(&w->bfs->start);
+    }
+    return NULL;
+}
+
+/** Parte de un hilo en la búsqueda en curso, que hacen todos a la vez.
+ * Por cada nivel: los hilos toman bloques de la frontera (o de los nodos, si
+ * el paso es de abajo hacia arriba) y agregan a su buffer los nodos del nivel
+ * siguiente; tras una barrera, cada uno copia su buffer a la frontera
+ * siguiente detrás de los de los hilos anteriores; tras otra barrera, todos
+ * pasan al nivel siguiente. Todo lo que decide cómo seguir se lee entre las
+ * dos barreras, cuando ya no cambia, así todos los hilos toman las mismas
+ * decisiones y terminan en el mismo nivel.
+ * \param w Los datos del hilo.
+ */
+static void bfs_search(BfsWorker *w){
+    Bfs bfs = w->bfs;       /*El buscador*/
+    u64 *front, *next, *tmp;/*Fronteras del nivel actual y el siguiente*/
+    u64 frontLen;           /*Cantidad de nodos en 'front'*/
+    u64 offset, total;      /*Lugar del buffer propio y largo de 'next'*/
+    u64 mf;                 /*Arcos de los nodos de 'next'*/
+    u64 mu;                 /*Arcos de los nodos sin visitar*/
+    u64 i, lo, hi;          /*Iterador y porción propia de un bitmap*/
+    unsigned int k;         /*Índice de hilo*/
+    unsigned int par = 0;   /*Paridad del nivel actual*/
+    int l = 0;              /*Nivel de la frontera actual*/
+    bool up = false;        /*El nivel actual se arma de abajo hacia arriba*/
+    bool nextUp;            /*El nivel siguiente se arma de abajo hacia arriba*/
+    bool done = false;      /*Terminó la búsqueda*/
+    
+    front = bfs->front;
+    next = bfs->next;
+    frontLen = bfs->frontLen;
+    mu = bfs->mu;
+    lo = bfs->words * w->k / bfs->threads;
+    hi = bfs->words * (w->k + 1) / bfs->threads;
+    while(!done){
+        if (up)
+            bfs_bottomUp(w, par, l + 1);
+        else
+            bfs_topDown(w, front, frontLen, par, l + 1);
+        pthread_barrier_wait(&bfs->step);
+        
+        offset = 0;
+        total = 0;
+        mf = 0;
+        for(k = 0; k < bfs->threads; k++){
+            if (k < w->k)
+                offset += bfs->w[k].len;
+            total += bfs->w[k].len;
+            mf += bfs->w[k].deg;
+        }
+        mu -= mf;
+        done = bfs->reached || total == 0;
+        /*Heurística de cambio de dirección*/
+        if (up)
+            nextUp = !done && total >= bfs->n / BFS_BETA;
+        else
+            nextUp = !done && mf > mu / BFS_ALPHA;
+        /*Junto los buffers en la siguiente frontera, en orden de hilo*/
+        for(i = 0; i < w->len; i++)
+            next[offset + i] = w->buf[i];
+        if (nextUp){
+            for(i = 0; i < w->len; i++)
+                __atomic_fetch_or(&bfs->fbits[1 - par][WORD(w->buf[i])],
+                                  BIT(w->buf[i]), __ATOMIC_RELAXED);
+        }
+        /*Vacío la porción propia del bitmap de la frontera ya usada*/
+        if (up){
+            for(i = lo; i < hi; i++)
+                bfs->fbits[par][i] = 0;
+        }
+        if (w->k == 0)
+            bfs->pos[1 - par] = 0;
+        pthread_barrier_wait(&bfs->step);
+        
+        w->len = 0;
+        w->deg = 0;
+        tmp = front;
+        front = next;
+        next = tmp;
+        frontLen = total;
+        par = 1 - par;
+        up = nextUp;
+        l++;
+    }
+}
+
+/** Paso de arriba hacia abajo: el hilo toma bloques de la frontera y expande
+ * sus nodos.
+ * \param w         Los datos del hilo.
+ * \param front     La frontera del nivel actual.
+ * \param frontLen  Cantidad de nodos en \p front.
+ * \param par       Paridad del nivel actual.
+ * \param l         Nivel de los nodos que se encuentren.
+ */
+static void bfs_topDown(BfsWorker *w, const u64 *front, u64 frontLen,
+                        unsigned int par, int l){
+    Bfs bfs = w->bfs;       /*El buscador*/
+    u64 i, end;             /*Bloque tomado de la frontera*/
+    
+    i = __atomic_fetch_add(&bfs->pos[par], BFS_CHUNK, __ATOMIC_RELAXED);
+    while(i < frontLen && !__atomic_load_n(&bfs->reached, __ATOMIC_RELAXED)){
+        end = i + BFS_CHUNK < frontLen ? i + BFS_CHUNK : frontLen;
+        for(; i < end; i++)
+            bfs_expand(w, front[i], l);
+        i = __atomic_fetch_add(&bfs->pos[par], BFS_CHUNK, __ATOMIC_RELAXED);
+    }
+}
+
+/** Paso de abajo hacia arriba: el hilo toma bloques de palabras del bitmap de
+ * visitados y cada nodo sin visitar busca un padre en la frontera.
+ * Cada palabra es de un solo hilo, así que sus bits se escriben sin atómicas.
+ * \param w     Los datos del hilo.
+ * \param par   Paridad del nivel actual.
+ * \param l     Nivel de los nodos que se encuentren.
+ */
+static void bfs_bottomUp(BfsWorker *w, unsigned int par, int l){
+    Bfs bfs = w->bfs;       /*El buscador*/
+    u64 i, end;             /*Bloque tomado del bitmap*/
+    u64 unseen;             /*Bits de los nodos sin visitar de una palabra*/
+    u64 v;                  /*Nodo sin visitar*/
+    
+    i = __atomic_fetch_add(&bfs->pos[par], BFS_WORDS, __ATOMIC_RELAXED);
+    while(i < bfs->words && !__atomic_load_n(&bfs->reached, __ATOMIC_RELAXED)){
+        end = i + BFS_WORDS < bfs->words ? i + BFS_WORDS : bfs->words;
+        for(; i < end; i++){
+            unseen = ~bfs->visited[i];
+            while(unseen != 0){
+                v = 64 * i + (u64) __builtin_ctzll(unseen);
+                unseen &= unseen - 1;
+                if (v < bfs->n)
+                    bfs_adopt(w, v, bfs->fbits[par], l);
+            }
+        }
+        i = __atomic_fetch_add(&bfs->pos[par], BFS_WORDS, __ATOMIC_RELAXED);
+    }
+}
+
+/** Reclama el nivel de los vecinos de 'x' que todavía no lo tienen y por los
+ * que se puede enviar flujo, y los agrega al buffer del hilo.
+ * \param w Los datos del hilo.
+ * \param x Id del nodo a expandir.
+ * \param l Nivel de los vecinos de \p x.
+ */
+static void bfs_expand(BfsWorker *w, u64 x, int l){
+    Bfs bfs = w->bfs;       /*El buscador*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'x'*/
+    u64 y;                  /*Vecino de 'x'*/
+    int nil;                /*Valor esperado del nivel de 'y'*/
+    
+    end = nbrhd_arcEnd(bfs->csr, x);
+    for(a = nbrhd_arcBegin(bfs->csr, x); a < end; a++){
+        if (nbrhd_arcResidual(bfs->csr, 
+                bfs->reverse ? nbrhd_arcPair(bfs->csr, a) : a) > 0){
+            y = nbrhd_arcHead(bfs->csr, a);
+            nil = LVL_NIL;
+            /*Solo un hilo gana el nodo y lo agrega a su buffer*/
+            if ((__atomic_load_n(&bfs->visited[WORD(y)], __ATOMIC_RELAXED) 
+                 & BIT(y)) == 0 &&
+                __atomic_compare_exchange_n(&bfs->lvl[y], &nil, l, false,
+                                            __ATOMIC_RELAXED, __ATOMIC_RELAXED)){
+                __atomic_fetch_or(&bfs->visited[WORD(y)], BIT(y), 
+                                  __ATOMIC_RELAXED);
+                bfs_push(w, y);
+            }
+        }
+    }
+}
+
+/** Busca entre los arcos de 'v' uno con residuo que le llegue desde un nodo
+ * de la frontera. Si lo encuentra, 'v' toma el nivel 'l' y se agrega al
+ * buffer del hilo.
+ * \param w     Los datos del hilo.
+ * \param v     Id de un nodo sin visitar.
+ * \param fbits Bitmap de la frontera.
+ * \param l     Nivel de los nodos que se encuentren.
+ */
+static void bfs_adopt(BfsWorker *w, u64 v, const u64 *fbits, int l){
+    Bfs bfs = w->bfs;       /*El buscador*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'v'*/
+    u64 x;                  /*Vecino de 'v'*/
+    bool found = false;     /*Se encontró un padre en la frontera*/
+    
+    end = nbrhd_arcEnd(bfs->csr, v);
+    for(a = nbrhd_arcBegin(bfs->csr, v); a < end && !found; a++){
+        x = nbrhd_arcHead(bfs->csr, a);
+        /*El arco opuesto lleva de 'x' a 'v'. Hacia atrás se usa 'a'*/
+        found = (fbits[WORD(x)] & BIT(x)) != 0 &&
+                nbrhd_arcResidual(bfs->csr, 
+                    bfs->reverse ? a : nbrhd_arcPair(bfs->csr, a)) > 0;
+    }
+    if (found){
+        bfs->lvl[v] = l;
+        bfs->visited[WORD(v)] |= BIT(v);
+        bfs_push(w, v);
+    }
+}
+
+/** Agrega al buffer del hilo un nodo que acaba de tomar su nivel.
+ * \param w Los datos del hilo.
+ * \param y Id del nodo.
+ */
+static void bfs_push(BfsWorker *w, u64 y){
+    Bfs bfs = w->bfs;       /*El buscador*/
+    
+    if (w->len == w->size){
+        w->size = w->size == 0 ? 1024 : 2 * w->size;
+        w->buf = (u64*) realloc(w->buf, w->size * sizeof(u64));
+        assert(w->buf != NULL);
+    }
+    w->buf[w->len++] = y;
+    w->deg += nbrhd_arcEnd(bfs->csr, y) - nbrhd_arcBegin(bfs->csr, y);
+    if (y == bfs->t)
+        __atomic_store_n(&bfs->reached, true, __ATOMIC_RELAXED);
+}
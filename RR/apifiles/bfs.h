@@ -0,0 +1,84 @@
+﻿#ifndef _BFS_H
+#define _BFS_H
+
+#include <stdbool.h>
+#include "_u64.h"
+#include "nbrhd.h"
+
+/** \file bfs.h
+ * Búsqueda BFS en paralelo sobre la CSR de un network, para armar los niveles
+ * de distancia desde 's' en máquinas con varios núcleos.
+ * La búsqueda avanza de a un nivel por vez (sincronizada por niveles): la
+ * frontera del nivel actual se reparte entre los hilos de a bloques, cada hilo
+ * reclama con una operación atómica el nivel de los vecinos que encuentra y
+ * los guarda en su propio buffer, y al terminar el nivel los buffers se juntan
+ * en la frontera siguiente.
+ * Cuando la frontera crece tanto que casi todos los vecinos que revisaría ya
+ * están visitados, el nivel se arma de abajo hacia arriba: cada nodo sin
+ * visitar busca un padre en la frontera (guardada en un bitmap) y deja de
+ * buscar al encontrarlo. Cuando la frontera vuelve a achicarse, se vuelve a
+ * armar de arriba hacia abajo.
+ * Los niveles asignados son las distancias desde 's', igual que en un BFS en
+ * serie; lo único que cambia es el orden en el que se visitan los nodos de un
+ * mismo nivel.
+ */
+
+/** \struct Bfs
+ * Puntero a un buscador BFS en paralelo y sus hilos. */
+typedef struct BfsSt *Bfs;
+
+
+/*          Funciones
+ */
+
+/* Crea un buscador que trabaja con 'threads' hilos.
+ * El hilo que llama a bfs_run() es uno de ellos: se lanzan 'threads'-1 hilos
+ * que esperan hasta que haya una búsqueda para hacer.
+ * threads Cantidad de hilos.
+ * pre: threads > 0.
+ * return: Un nuevo Bfs. El llamador se encarga de destruirlo.
+ */
+Bfs bfs_create(unsigned int threads);
+
+/* Destructor de un Bfs. Termina sus hilos.
+ * pre: 'bfs' no es nulo y no hay una búsqueda en curso.
+ */
+void bfs_destroy(Bfs bfs);
+
+/* Cantidad de hilos con los que trabaja el buscador.
+ * pre: 'bfs' no es nulo.
+ */
+unsigned int bfs_threads(Bfs bfs);
+
+/* Asigna a cada nodo su distancia desde 's' por arcos con residuo positivo.
+ * La búsqueda termina al completar el nivel en el que se alcanza 't' (en ese
+ * nivel puede quedar algún nodo sin su distancia) o al acabarse los nodos.
+ * bfs   El buscador.
+ * csr   La CSR del network.
+ * n     Cantidad de nodos de 'csr'.
+ * lvl   Arreglo de 'n' distancias. Las no asignadas valen -1.
+ * s     Id del nodo fuente.
+ * t     Id del nodo resumidero.
+ * pre: 'bfs', 'csr' y 'lvl' no son nulos. lvl[i] == -1 para todo nodo 'i'.
+ *      's' y 't' son ids validos.
+ * return: true si se alcanzó 't'.
+ *         false caso contrario.
+ */
+bool bfs_run(Bfs bfs, NbrhdCsr csr, u64 n, int *lvl, u64 s, u64 t);
+
+/* Asigna a cada nodo su distancia hasta 't' por arcos con residuo positivo,
+ * sin pasar por 's'.
+ * Es el mismo BFS que bfs_run(), pero hacia atrás desde 't' y sin cortar: los
+ * nodos que no llegan a 't', y 's', quedan sin distancia.
+ * bfs   El buscador.
+ * csr   La CSR del network.
+ * n     Cantidad de nodos de 'csr'.
+ * lvl   Arreglo de 'n' distancias. Las no asignadas valen -1.
+ * t     Id del nodo resumidero.
+ * s     Id del nodo fuente.
+ * pre: 'bfs', 'csr' y 'lvl' no son nulos. lvl[i] == -1 para todo nodo 'i'.
+ *      's' y 't' son ids validos y distintos.
+ */
+void bfs_toSink(Bfs bfs, NbrhdCsr csr, u64 n, int *lvl, u64 t, u64 s);
+
+#endif
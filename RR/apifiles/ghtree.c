@@ -0,0 +1,234 @@
+﻿#include <assert.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include "ghtree.h"
+#include "preflow.h"
+
+/** Estructura de un árbol de Gomory-Hu.
+ * El árbol se guarda con un padre por nodo; como cada nodo tiene un id mayor
+ * que el de su padre, la profundidad se calcula en una pasada en orden de id.
+ */
+struct GhTreeSt{
+    u64 n;              /**<Cantidad de nodos.*/
+    u64 *parent;        /**<Padre de cada nodo. La raíz es su propio padre.*/
+    u64 *weight;        /**<Corte minimal entre cada nodo y su padre.*/
+    u64 *depth;         /**<Distancia de cada nodo a la raíz.*/
+};
+
+/** Un flujo de una tanda, con los datos propios del hilo que lo calcula.*/
+typedef struct GhSlotSt{
+    NbrhdCsr net;       /**<CSR del network, que solo se lee.*/
+    NbrhdCsr csr;       /**<CSR con los residuos propios del hilo.*/
+    u64 *res;           /**<Residuos propios, uno por arco.*/
+    u64 *queue;         /**<Cola del BFS que arma el corte.*/
+    bool *side;         /**<Nodos del lado de 'v' en el corte.*/
+    u64 n;              /**<Cantidad de nodos.*/
+    u64 v;              /**<Nodo cuyo corte se calcula.*/
+    u64 target;         /**<Padre de 'v' al empezar la tanda.*/
+    u64 value;          /**<Capacidad del corte entre 'v' y 'target'.*/
+} GhSlot;
+
+/* Funciones estáticas */
+static void *gh_solve(void *arg);
+static void gh_commit(GhTree tree, GhSlot *slot);
+
+
+/** Arma el árbol de Gomory-Hu del network de \p csr, tomado como no dirigido.
+ * En cada tanda se toman los siguientes nodos sin corte, tantos como hilos,
+ * y se calcula a la vez el flujo entre cada uno y su padre. Luego se
+ * confirman en orden: el de Gusfield es un recorrido en orden de id, y el
+ * corte de un nodo cambia el padre de los nodos mayores de su lado, así que
+ * se confirman mientras el padre de cada uno siga siendo el que se usó. El
+ * primero de la tanda siempre se confirma.
+ * \param csr     La CSR del network.
+ * \param n       Cantidad de nodos de \p csr.
+ * \param threads Cantidad de flujos que se calculan a la vez.
+ * \pre \p csr no es nulo. \p threads > 0.
+ * \return Un nuevo GhTree. El llamador se encarga de destruirlo.
+ */
+GhTree ghtree_build(NbrhdCsr csr, u64 n, unsigned int threads){
+    GhTree tree = NULL;     /*El árbol a armar. Retorno*/
+    GhSlot *slot = NULL;    /*Flujos de la tanda, uno por hilo*/
+    pthread_t *tid = NULL;  /*Hilos lanzados, del 1 al k-1*/
+    u64 arcs;               /*Cantidad de arcos de la CSR*/
+    u64 next = 1;           /*Primer nodo sin corte confirmado*/
+    unsigned int k;         /*Cantidad de flujos de la tanda*/
+    unsigned int j;         /*Índice del flujo en la tanda*/
+    u64 i;                  /*Id del nodo actual*/
+    int err;                /*Error de pthread*/
+    
+    assert(csr != NULL && threads > 0);
+    
+    tree = (GhTree) malloc(sizeof(struct GhTreeSt));
+    assert(tree != NULL);
+    tree->n = n;
+    tree->parent = (u64*) calloc(n + 1, sizeof(u64));
+    tree->weight = (u64*) calloc(n + 1, sizeof(u64));
+    tree->depth = (u64*) calloc(n + 1, sizeof(u64));
+    assert(tree->parent != NULL && tree->weight != NULL);
+    assert(tree->depth != NULL);
+    
+    if (n > 1){
+        if (threads > n - 1)
+            threads = (unsigned int) (n - 1);
+        arcs = nbrhd_arcEnd(csr, n - 1);
+        slot = (GhSlot*) malloc(threads * sizeof(GhSlot));
+        tid = (pthread_t*) malloc(threads * sizeof(pthread_t));
+        assert(slot != NULL && tid != NULL);
+        for(j = 0; j < threads; j++){
+            slot[j].net = csr;
+            slot[j].res = (u64*) malloc((arcs + 1) * sizeof(u64));
+            slot[j].queue = (u64*) malloc(n * sizeof(u64));
+            slot[j].side = (bool*) malloc(n * sizeof(bool));
+            assert(slot[j].res != NULL && slot[j].queue != NULL);
+            assert(slot[j].side != NULL);
+            slot[j].csr = nbrhd_csrShare(csr, slot[j].res);
+            slot[j].n = n;
+        }
+        while(next < n){
+            k = n - next < threads ? (unsigned int) (n - next) : threads;
+            for(j = 0; j < k; j++){
+                slot[j].v = next + j;
+                slot[j].target = tree->parent[next + j];
+            }
+            for(j = 1; j < k; j++){
+                err = pthread_create(&tid[j], NULL, gh_solve, &slot[j]);
+                assert(err == 0);
+            }
+            gh_solve(&slot[0]);
+            for(j = 1; j < k; j++)
+                pthread_join(tid[j], NULL);
+            /*Se confirman en orden mientras el padre no haya cambiado*/
+            for(j = 0; j < k && tree->parent[slot[j].v] == slot[j].target; 
+                j++)
+                gh_commit(tree, &slot[j]);
+            next += j;
+        }
+        for(j = 0; j < threads; j++){
+            nbrhd_csrDestroy(slot[j].csr);
+            free(slot[j].res);
+            free(slot[j].queue);
+            free(slot[j].side);
+        }
+        free(slot);
+        free(tid);
+    }
+    for(i = 1; i < n; i++)
+        tree->depth[i] = tree->depth[tree->parent[i]] + 1;
+    (void) err;
+    return tree;
+}
+
+/** Destructor de un GhTree.
+ * \param tree  El árbol.
+ * \pre \p tree no es nulo.
+ */
+void ghtree_destroy(GhTree tree){
+    assert(tree != NULL);
+    free(tree->parent);
+    free(tree->weight);
+    free(tree->depth);
+    free(tree);
+}
+
+/** Padre del nodo \p v en el árbol. La raíz (el nodo 0) es su propio padre.
+ * \param tree  El árbol.
+ * \param v     El id del nodo.
+ * \pre \p tree no es nulo y \p v es un id valido.
+ */
+u64 ghtree_parent(GhTree tree, u64 v){
+    assert(tree != NULL && v < tree->n);
+    return tree->parent[v];
+}
+
+/** Capacidad del corte minimal entre el nodo \p v y su padre.
+ * \param tree  El árbol.
+ * \param v     El id del nodo.
+ * \pre \p tree no es nulo y \p v es un id valido distinto de la raíz.
+ */
+u64 ghtree_weight(GhTree tree, u64 v){
+    assert(tree != NULL && v < tree->n && v > 0);
+    return tree->weight[v];
+}
+
+/** Capacidad del corte minimal entre los nodos \p u y \p v.
+ * Se sube desde el más profundo de los dos hasta que se encuentran, y se
+ * toma el menor peso de los lados recorridos.
+ * \param tree  El árbol.
+ * \param u     El id de un nodo.
+ * \param v     El id del otro nodo.
+ * \pre \p tree no es nulo. \p u y \p v son ids validos y distintos.
+ * \return El menor peso del camino entre \p u y \p v en el árbol.
+ */
+u64 ghtree_minCut(GhTree tree, u64 u, u64 v){
+    u64 result = u64_MAX;   /*Menor peso encontrado. Retorno*/
+    u64 w;                  /*Para intercambiar 'u' y 'v'*/
+    
+    assert(tree != NULL && u < tree->n && v < tree->n && u != v);
+    while(u != v){
+        /*Sube el más profundo*/
+        if (tree->depth[u] < tree->depth[v]){
+            w = u;
+            u = v;
+            v = w;
+        }
+        result = u64_min(result, tree->weight[u]);
+        u = tree->parent[u];
+    }
+    return result;
+}
+
+/** Calcula el flujo maximal entre el nodo de un flujo de la tanda y su padre,
+ * sobre los residuos propios del hilo, y arma el lado del corte de 'v': los
+ * nodos a los que se llega desde 'v' por arcos con residuo.
+ * Como el network se toma como no dirigido, cada arco empieza con la
+ * capacidad de su lado como residuo.
+ * \param arg   El GhSlot del flujo.
+ * \return NULL.
+ */
+static void *gh_solve(void *arg){
+    GhSlot *slot = (GhSlot*) arg;   /*El flujo a calcular*/
+    u64 head = 0, tail = 0;         /*Extremos de la cola*/
+    u64 a, end;                     /*Arco actual y fin de los arcos de 'w'*/
+    u64 w, y;                       /*Nodo que se expande y su vecino*/
+    
+    end = nbrhd_arcEnd(slot->net, slot->n - 1);
+    for(a = 0; a < end; a++)
+        slot->res[a] = nbrhd_arcCap(slot->net, a);
+    slot->value = preflow_maxFlow(slot->csr, slot->n, slot->v, slot->target,
+                                  PREFLOW_HL);
+    for(w = 0; w < slot->n; w++)
+        slot->side[w] = false;
+    slot->side[slot->v] = true;
+    slot->queue[tail++] = slot->v;
+    while(head < tail){
+        w = slot->queue[head++];
+        end = nbrhd_arcEnd(slot->csr, w);
+        for(a = nbrhd_arcBegin(slot->csr, w); a < end; a++){
+            y = nbrhd_arcHead(slot->csr, a);
+            if (!slot->side[y] && nbrhd_arcResidual(slot->csr, a) > 0){
+                slot->side[y] = true;
+                slot->queue[tail++] = y;
+            }
+        }
+    }
+    return NULL;
+}
+
+/** Confirma el corte de un flujo de la tanda: fija el peso del lado entre
+ * 'v' y su padre, y los nodos mayores que 'v' de su lado del corte que
+ * colgaban del mismo padre pasan a colgar de 'v'.
+ * \param tree  El árbol.
+ * \param slot  El flujo, calculado con el padre actual de 'v'.
+ */
+static void gh_commit(GhTree tree, GhSlot *slot){
+    u64 i;  /*Id del nodo actual*/
+    
+    assert(tree->parent[slot->v] == slot->target);
+    tree->weight[slot->v] = slot->value;
+    for(i = slot->v + 1; i < tree->n; i++){
+        if (slot->side[i] && tree->parent[i] == slot->target)
+            tree->parent[i] = slot->v;
+    }
+}
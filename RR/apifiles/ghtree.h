@@ -0,0 +1,65 @@
+﻿#ifndef _GHTREE_H
+#define _GHTREE_H
+
+#include "_u64.h"
+#include "nbrhd.h"
+
+/** \file ghtree.h
+ * Árbol de Gomory-Hu de un network, para conocer el corte minimal entre
+ * cualquier par de nodos sin volver a calcular flujos.
+ * El árbol tiene los mismos nodos que el network, y cada nodo 'v' (salvo la
+ * raíz, el nodo 0) tiene un padre con el que lo une un lado de peso igual a
+ * la capacidad del corte minimal entre ambos. La capacidad del corte minimal
+ * entre dos nodos cualesquiera es el menor peso del camino que los une en el
+ * árbol.
+ * Estos árboles solo existen para networks no dirigidos, así que el network
+ * se toma como no dirigido: un lado 'xy' de capacidad c permite enviar hasta
+ * c de 'x' a 'y' o de 'y' a 'x'.
+ * Se arma con el método de Gusfield: n-1 flujos maximales, cada uno entre un
+ * nodo y su padre en el árbol hasta el momento, sobre el network original.
+ * Los flujos se calculan de a varios a la vez, cada uno en un hilo con su
+ * propia copia de los residuos. Cada flujo supone el padre que tenía su nodo
+ * al empezar, y el corte de un nodo anterior puede cambiárselo: en ese caso
+ * ese flujo (y los siguientes) se vuelve a calcular en la próxima tanda.
+ */
+
+/** \struct GhTree
+ * Puntero a un árbol de Gomory-Hu. */
+typedef struct GhTreeSt *GhTree;
+
+
+/*          Funciones
+ */
+
+/* Arma el árbol de Gomory-Hu del network de 'csr', tomado como no dirigido.
+ * No cambia el flujo de 'csr'.
+ * csr     La CSR del network.
+ * n       Cantidad de nodos de 'csr'.
+ * threads Cantidad de flujos que se calculan a la vez, cada uno en un hilo.
+ * pre: 'csr' no es nulo. threads > 0.
+ * return: Un nuevo GhTree. El llamador se encarga de destruirlo.
+ */
+GhTree ghtree_build(NbrhdCsr csr, u64 n, unsigned int threads);
+
+/* Destructor de un GhTree.
+ * pre: 'tree' no es nulo.
+ */
+void ghtree_destroy(GhTree tree);
+
+/* Padre del nodo 'v' en el árbol. La raíz (el nodo 0) es su propio padre.
+ * pre: 'tree' no es nulo y 'v' es un id valido.
+ */
+u64 ghtree_parent(GhTree tree, u64 v);
+
+/* Capacidad del corte minimal entre el nodo 'v' y su padre.
+ * pre: 'tree' no es nulo y 'v' es un id valido distinto de la raíz.
+ */
+u64 ghtree_weight(GhTree tree, u64 v);
+
+/* Capacidad del corte minimal entre los nodos 'u' y 'v': el menor peso del
+ * camino entre ellos en el árbol. Se recorre solo ese camino.
+ * pre: 'tree' no es nulo. 'u' y 'v' son ids validos y distintos.
+ */
+u64 ghtree_minCut(GhTree tree, u64 u, u64 v);
+
+#endif
@@ -1,6 +1,8 @@
 ﻿#include "nbrhd.h"
 #include "__uthash.h"
+#include "_arena.h"
 #include <stdlib.h>
+#include <stdbool.h>
 #include <assert.h>
 
 /** \file nbrhd.c
@@ -10,6 +12,12 @@
  * en nbrhd.h
  */
 
+#define CSR_WBUF 1024       /**<u64 que nbrhd_csrWrite() junta antes de
+                            escribirlos.*/
+/** ¿El arco 'a' está marcado en el bitset 'dead' de nbrhd_csrWrite()?*/
+#define CSR_DEAD(dead, a) ((dead) != NULL && \
+                           ((dead)[(a) >> 6] & ((u64) 1 << ((a) & 63))) != 0)
+
 
 /** Estructura de una artista en sentido forward.
  * Relación 'xy' (y es nodo forward de x).
@@ -18,6 +26,7 @@ typedef struct FedgeSt{
     u64 y;                  /**<Nodo forward de 'x'. Es key de la hash.*/
     u64 cap;                /**<La capacidad de envío de flujo.*/
     u64 flow;               /**<El flujo que se esta enviando.*/
+    u64 arc;                /**<Arco FWD que lo representa en la CSR.*/
     UT_hash_handle hhfNbrs; /**<La tabla hash.*/
 } Fedge;
 
@@ -37,163 +46,209 @@ typedef struct BedgeSt{
 struct NeighbourhoodSt{
     Fedge *fNbrs;       /**<Vecinos forward. Hash de vecinos forward de 'x'.*/
     Bedge *bNbrs;       /**<Vecinos backward. Hash de vecinos backward de 'x'.*/
+    Arena arena;        /**<Arena de la que se piden los vecinos.*/
+};
+
+/** Estructura NbrhdCsr con todas las vecindades congeladas en arreglos.
+ * Los arcos del nodo 'x' son los índices [first[x], first[x+1]); los FWD van
+ * primero y los BWD empiezan en mid[x]. Los dos arcos de un lado 'xy' (el FWD
+ * en la fila de 'x' y el BWD en la fila de 'y') se referencian entre sí en
+ * \p pair, y cada uno guarda en \p res cuánto flujo se puede enviar por él:
+ * el FWD la capacidad menos el flujo, y el BWD el flujo. Así la capacidad del
+ * lado es la suma de ambos y su flujo es el residual del BWD.
+ */
+struct NbrhdCsrSt{
+    u64 n;              /**<Cantidad de nodos.*/
+    u64 m;              /**<Cantidad de lados.*/
+    u64 *first;         /**<Primer arco de cada nodo (n+1 elementos).*/
+    u64 *mid;           /**<Primer arco BWD de cada nodo (n elementos).*/
+    u64 *head;          /**<Vecino al que lleva cada arco (2m elementos).*/
+    u64 *pair;          /**<Arco opuesto del mismo lado (2m elementos).*/
+    u64 *res;           /**<Capacidad residual de cada arco (2m elementos).*/
+    bool owned;         /**<Los arreglos se liberan con la CSR. Es false si
+                        se armó con nbrhd_csrMap().*/
 };
 
 /* Funciones estáticas */
 static void *findNbr(Nbrhd nbrs, u64 y, short int dir);
-static Fedge *fedge_create(u64 y, u64 c);
-static Bedge *bedge_create(u64 y, Fedge *fNbr);
-static void fedge_destroy(Fedge *fNbrs);
-static void bedge_destroy(Bedge *bNbrs);
+static Fedge *fedge_create(Arena arena, u64 y, u64 c);
+static Bedge *bedge_create(Arena arena, u64 y, Fedge *fNbr);
+static bool csr_put(u64 *buf, u64 *len, u64 v, FILE *f);
 
 
 /** Constructor de un nuevo Nbrhd.
+ * El Nbrhd y todos los vecinos que se le agreguen se piden a \p arena, por lo
+ * que viven hasta que se destruya la arena.
+ * \param arena La arena de la que se pide la memoria.
+ * \pre \p arena no es nula.
  * \return un \p Nbrhd vacío.
  */
-Nbrhd nbrhd_create(void){
+Nbrhd nbrhd_create(Arena arena){
     Nbrhd nbrs = NULL;  /*nuevo Nbrhd*/
+    
+    assert(arena != NULL);
     /*asigno memoria*/
-    nbrs = (Nbrhd) malloc(sizeof(struct NeighbourhoodSt));
-    assert(nbrs != NULL);
+    nbrs = (Nbrhd) arena_alloc(arena, sizeof(struct NeighbourhoodSt));
     /*inicializo campos*/
     nbrs->fNbrs = NULL;
     nbrs->bNbrs = NULL;
+    nbrs->arena = arena;
     
     return nbrs;
 }
 
 /** Destructor de un Nbrhd.
+ * Se liberan las tablas hash de los vecinos. El Nbrhd y los vecinos se liberan
+ * al destruir la arena de la que se pidieron.
  * \pre \p Nbrhd no es nulo.
  */
 void nbrhd_destroy(Nbrhd nbrs){
     assert(nbrs != NULL);
-    /*Destruyo todos los vecinos forward*/
-    if (nbrs->fNbrs != NULL)
-        fedge_destroy(nbrs->fNbrs);
-    /*Destruyo todos los vecinos backward*/
-    if (nbrs->bNbrs != NULL)
-        bedge_destroy(nbrs->bNbrs);    
-    free(nbrs);
-    nbrs = NULL;
+    HASH_CLEAR(hhfNbrs, nbrs->fNbrs);
+    HASH_CLEAR(hhbNbrs, nbrs->bNbrs);
 }
 
 /** Genera el vinculo entre 'x' e 'y' (edge) convirtiéndolos en vecinos.
  * La relación es 'xy': 'y' vecino forward de 'x'; 'x' vecino backward de 'y'.
- * \pre 'x', 'y', 'edge' no son nulos.
+ * \pre 'x', 'y' no son nulos.
  * \param x Vecindario del nodo 'x'.
  * \param y Vecindario del nodo 'y'.
- * \param edge Lado 'xy' con su capacidad y flujo.
+ * \param xName Nombre del nodo 'x'.
+ * \param yName Nombre del nodo 'y'.
+ * \param c Capacidad del lado 'xy'.
  */
-void nbrhd_addEdge(Nbrhd x, Nbrhd y, Lado edge){
+void nbrhd_addEdge(Nbrhd x, Nbrhd y, u64 xName, u64 yName, u64 c){
     Fedge *fNbr = NULL;     /*Vecino forward*/
     Bedge *bNbr = NULL;     /*Vecino backward*/
-    u64 yName;              /*Nombre del nodo 'y'*/
     
-    assert(x!=NULL && y!=NULL && edge!=LadoNulo);
+    assert(x!=NULL && y!=NULL);
     
     /*Se busca si ya existe una entrada para el lado 'xy'*/
-    yName = lado_getY(edge);
     HASH_FIND(hhfNbrs, x->fNbrs, &(yName), sizeof(x->fNbrs->y), fNbr);
     /*Si no existe, creo las estructuras correspondientes*/
     if(fNbr == NULL){
         /*Creo a 'y' como vecino forward de 'x'*/
-        fNbr = fedge_create(yName, lado_getCap(edge));
+        fNbr = fedge_create(x->arena, yName, c);
         HASH_ADD(hhfNbrs, x->fNbrs, y, sizeof(x->fNbrs->y), fNbr);
         
         /*Creo a 'x' como vecino backward de 'y'*/
-        bNbr = bedge_create(lado_getX(edge), fNbr);
+        bNbr = bedge_create(y->arena, xName, fNbr);
         HASH_ADD(hhbNbrs, y->bNbrs, y, sizeof(y->bNbrs->y), bNbr);
     /*Si existe, es un caso de lados paralelos*/
     }else{
-        fNbr->cap += lado_getCap(edge);
+        fNbr->cap += c;
     }
         
 }
 
-/** Busca el siguiente vecino forward.
- * La petición de búsqueda puede ser por el primer nodo (FST) de la tabla, 
- * o bien por el siguiente(NXT) del ultimo pedido. 
- * Si existe almacena el nombre en 'y'.
- * 
- * \note Tener en cuenta la documentación sobre las opciones de los parámetros.
- * Verlo como un iterador de consultas a una tabla.
- * 
- * \param nbrs  El vecindario del nodo ancestro 'x'. 
- * \param rqst  Si se pide el primero 'FST' o un siguiente 'NXT'.
- * \param y     Variable en la que se almacena el nombre del vecino encontrado.
- * \pre 'nbrs' e 'y' no son nulos y 'rqst' es una opción valida (FST o NXT).
+/** Indica si existe el lado 'xy'.
+ * \param nbrs  Vecindario del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \pre \p nbrs no es nulo.
+ * \return  true si 'y' es vecino forward de 'x'. \n
+ *          false caso contrario.
+ */
+bool nbrhd_hasEdge(Nbrhd nbrs, u64 y){
+    Fedge *fNbr = NULL;     /*Vecino forward*/
+
+    assert(nbrs != NULL);
+    HASH_FIND(hhfNbrs, nbrs->fNbrs, &(y), sizeof(y), fNbr);
+    return fNbr != NULL;
+}
+
+/** Fija en \p c la capacidad del lado 'xy'.
+ * No se toca el flujo: si la CSR está armada, el flujo que vale es el de ella.
+ * \param nbrs  Vecindario del nodo 'x'.
+ * \param y     Nombre del nodo 'y'.
+ * \param c     Nueva capacidad del lado.
+ * \pre \p nbrs no es nulo y el lado 'xy' existe.
+ */
+void nbrhd_setCap(Nbrhd nbrs, u64 y, u64 c){
+    Fedge *fNbr = NULL;     /*Vecino forward*/
+
+    assert(nbrs != NULL);
+    fNbr = findNbr(nbrs, y, FWD);
+    fNbr->cap = c;
+}
+
+/** Quita el lado 'xy': 'y' deja de ser vecino forward de 'x' y 'x' deja de
+ * ser vecino backward de 'y'. Los demás vecinos mantienen su orden.
+ * La memoria de los vecinos se libera con la arena.
+ * \param x     Vecindario del nodo 'x'.
+ * \param y     Vecindario del nodo 'y'.
+ * \param xName Nombre del nodo 'x'.
+ * \param yName Nombre del nodo 'y'.
+ * \pre 'x', 'y' no son nulos y el lado 'xy' existe.
+ */
+void nbrhd_removeEdge(Nbrhd x, Nbrhd y, u64 xName, u64 yName){
+    Fedge *fNbr = NULL;     /*Vecino forward*/
+    Bedge *bNbr = NULL;     /*Vecino backward*/
+
+    assert(x != NULL && y != NULL);
+    fNbr = findNbr(x, yName, FWD);
+    bNbr = findNbr(y, xName, BWD);
+    HASH_DELETE(hhfNbrs, x->fNbrs, fNbr);
+    HASH_DELETE(hhbNbrs, y->bNbrs, bNbr);
+}
+
+/** Inicia un recorrido por los vecinos de \p nbrs en la dirección \p dir.
+ * Los vecinos se visitan en el orden en que fueron agregados.
+ * \param it    El iterador a iniciar.
+ * \param nbrs  El vecindario del nodo ancestro 'x'.
+ * \param dir   Dirección de los vecinos a recorrer (FWD o BWD).
+ * \pre 'it' y 'nbrs' no son nulos. 'dir' es FWD o BWD.
+ */
+void nbrhd_iterInit(NbrhdIter *it, Nbrhd nbrs, short int dir){
+    assert(it != NULL && nbrs != NULL);
+    assert(dir == FWD || dir == BWD);
+    
+    it->nbr = NULL;
+    it->dir = dir;
+    if(dir == FWD)
+        it->next = nbrs->fNbrs;
+    else
+        it->next = nbrs->bNbrs;
+}
+
+/** Avanza al siguiente vecino del recorrido.
+ * Si existe, almacena su nombre en 'y' y queda como vecino actual.
+ * \param it  El iterador.
+ * \param y   Variable en la que se almacena el nombre del vecino encontrado.
+ * \pre 'it' fue iniciado con nbrhd_iterInit() e 'y' no es nulo.
  * \return 1 Si se encontró y se almacenó en 'y' un vecino.\n
  *         0 Caso contrario.
  */
-int nbrhd_getFwd(Nbrhd nbrs, int rqst, u64 *y){
-    static Fedge *fNbr = NULL;  /*Puntero al ultimo vecino forward consultado*/
-    int result = 0;             /*Valor de retorno*/
+int nbrhd_iterNext(NbrhdIter *it, u64 *y){
+    int result = 0;     /*Valor de retorno*/
     
-    assert(nbrs != NULL && y != NULL);
-    assert(rqst == FST || rqst == NXT);
+    assert(it != NULL && y != NULL);
     
-    if(nbrs->fNbrs != NULL){
-        /*Se asigna el primero de la tabla*/
-        if(rqst == FST){
-            fNbr = nbrs->fNbrs;
-            *y = fNbr->y;
-            result = 1;
-        /*Se pide el siguiente. El ultimo pedido esta referenciado en 'fNbr'*/
+    it->nbr = it->next;
+    if(it->nbr != NULL){
+        /*Se avanza según la tabla que se esta recorriendo*/
+        if(it->dir == FWD){
+            *y = ((Fedge*)it->nbr)->y;
+            it->next = ((Fedge*)it->nbr)->hhfNbrs.next;
         }else{
-            if(fNbr != NULL){
-                /*Se asigna el sig de la tabla, NULL si el anterior fue el ultimo*/
-                fNbr = fNbr->hhfNbrs.next;
-                if(fNbr != NULL){
-                    *y = fNbr->y;
-                    result = 1;
-                }
-            }
+            *y = ((Bedge*)it->nbr)->y;
+            it->next = ((Bedge*)it->nbr)->hhbNbrs.next;
         }
+        result = 1;
     }
-    return result;   
+    return result;
 }
 
-/** Busca el siguiente vecino backward.
- * La petición de búsqueda puede ser por el primer nodo (FST) de la tabla, 
- * o bien por el siguiente(NXT) del ultimo pedido. 
- * Si existe almacena el nombre en 'y'.
- * 
- * \note Tener en cuenta la documentación sobre las opciones de los parámetros.
- * Verlo como un iterador de consultas a una tabla.
- * 
- * \param nbrs  El vecindario del nodo ancestro 'x'. 
- * \param rqst  Si se pide el primero 'FST' o un siguiente 'NXT'.
- * \param y     Variable en la que se almacena el nombre del vecino encontrado.
- * \pre 'nbrs' e 'y' no son nulos y 'rqst' es una opción valida (FST o NXT).
- * \return 1 Si se encontró y se almaceno en 'y' un vecino.\n
- *         0 Caso contrario.
+/** Devuelve el flujo del lado con el vecino actual del recorrido.
+ * \param it  El iterador.
+ * \pre La última llamada a nbrhd_iterNext() con 'it' devolvió 1.
+ * \return El valor del flujo sobre este lado.
  */
-int nbrhd_getBwd(Nbrhd nbrs, int rqst, u64 *y){
-    static Bedge *bNbr = NULL;  /*Puntero al ultimo vecino backward consultado*/
-    int result = 0;             /*Valor de retorno*/
-    
-    assert(nbrs != NULL && y != NULL);
-    assert(rqst == FST || rqst == NXT);
+u64 nbrhd_iterFlow(const NbrhdIter *it){
+    Fedge *fNbr = NULL; /*El lado del vecino actual*/
     
-    if(nbrs->bNbrs != NULL){
-        /*Se asigna el primero de la tabla*/
-        if(rqst == FST){
-            bNbr = nbrs->bNbrs;
-            *y = bNbr->y;
-            result = 1;
-        /*Se pide el siguiente. El ultimo pedido esta referenciado en 'bNbr'*/
-        }else{
-            if(bNbr != NULL){
-                /*Se asigna el sig de la tabla, NULL si el anterior fue el ultimo*/
-                bNbr = bNbr->hhbNbrs.next;
-                if(bNbr != NULL){
-                    *y = bNbr->y;
-                    result = 1;
-                }
-            }
-        }
-    }
-    return result;   
+    assert(it != NULL && it->nbr != NULL);
+    fNbr = it->dir == FWD ? (Fedge*)it->nbr : ((Bedge*)it->nbr)->x;
+    return fNbr->flow;
 }
 
 /** Se aumenta el flujo para con el vecino 'y' por 'vf' cantidad. 
@@ -229,50 +284,480 @@ u64 nbrhd_increaseFlow(Nbrhd nbrs, u64 y, short int dir, u64 vf){
     return fNbr->flow;
 }
 
-/** Devuelve la capacidad del lado que relaciona al nodo ancestro 'x' con el 
- * vecino 'y'.
- * Como pueden haber loops hay que especificar si se esta tratando del lado 'xy'
- * o 'yx'.
- * \param nbrs  El vecindario del nodo ancestro 'x'. 
- * \param y     El nombre del vecino.
- * \param dir   Dirección que se encuentra el vecino (lado FWD o BWD).
- * \pre 'y' es vecino de 'x'. 
- * \return  La capacidad sobre este lado.
+/*
+ *          Funciones de la representación compacta (CSR)
  */
-u64 nbrhd_getCap(Nbrhd nbrs, u64 y, short int dir){
-    void *nbr = NULL;   /*El vecino*/
+
+/** Congela las vecindades de un network en una representación CSR.
+ * El nodo de la vecindad nbrs[i] pasa a identificarse con el id 'i'. Los
+ * flujos y capacidades actuales de cada lado se copian a la CSR; a partir de
+ * aquí el flujo se manipula sobre ella y se devuelve con nbrhd_sync().
+ * \note Primero se ubican los arcos FWD de todos los nodos, dejando
+ * provisoriamente en \p head el id del nodo dueño. Luego, al ubicar cada arco
+ * BWD se conoce el arco FWD de su lado (Bedge::x), por lo que se intercambian
+ * los extremos: el BWD lleva al dueño del FWD y el FWD al dueño del BWD.
+ * \param nbrs  Arreglo con las vecindades de todos los nodos del network.
+ * \param n     Cantidad de vecindades en \p nbrs.
+ * \pre \p nbrs no es nulo y todo vecino de una vecindad de \p nbrs tiene su
+ *      vecindad en \p nbrs.
+ * \return Una nueva CSR. El llamador se encarga de destruirla.
+ */
+NbrhdCsr nbrhd_freeze(Nbrhd *nbrs, u64 n){
+    NbrhdCsr csr = NULL;    /*La CSR a construir*/
+    Fedge *fNbr = NULL;     /*Vecino forward de la iteración*/
+    Bedge *bNbr = NULL;     /*Vecino backward de la iteración*/
+    u64 i, a;               /*Nodo y arco actuales*/
+    u64 fa;                 /*Arco FWD del lado de un vecino backward*/
     
     assert(nbrs != NULL);
-    assert(dir == FWD || dir == BWD);
+    
+    csr = (NbrhdCsr) malloc(sizeof(struct NbrhdCsrSt));
+    assert(csr != NULL);
+    csr->n = n;
+    csr->owned = true;
+    csr->first = (u64*) malloc((n+1) * sizeof(u64));
+    csr->mid = (u64*) malloc((n+1) * sizeof(u64));
+    assert(csr->first != NULL && csr->mid != NULL);
+    
+    /*Cada nodo ocupa tantos arcos como vecinos FWD y BWD tenga*/
+    csr->first[0] = 0;
+    for(i = 0; i < n; i++){
+        csr->mid[i] = csr->first[i] + HASH_CNT(hhfNbrs, nbrs[i]->fNbrs);
+        csr->first[i+1] = csr->mid[i] + HASH_CNT(hhbNbrs, nbrs[i]->bNbrs);
+    }
+    csr->m = csr->first[n] / 2;
+    csr->head = (u64*) malloc((2*csr->m + 1) * sizeof(u64));
+    csr->pair = (u64*) malloc((2*csr->m + 1) * sizeof(u64));
+    csr->res = (u64*) malloc((2*csr->m + 1) * sizeof(u64));
+    assert(csr->head != NULL && csr->pair != NULL && csr->res != NULL);
+    
+    /*Arcos FWD, en el orden de la hash. 'head' guarda por ahora al dueño*/
+    for(i = 0; i < n; i++){
+        a = csr->first[i];
+        for(fNbr = nbrs[i]->fNbrs; fNbr != NULL; fNbr = fNbr->hhfNbrs.next){
+            csr->head[a] = i;
+            csr->res[a] = fNbr->cap - fNbr->flow;
+            fNbr->arc = a;
+            a++;
+        }
+    }
+    /*Arcos BWD. Se completan los extremos y el par de ambos arcos del lado*/
+    for(i = 0; i < n; i++){
+        a = csr->mid[i];
+        for(bNbr = nbrs[i]->bNbrs; bNbr != NULL; bNbr = bNbr->hhbNbrs.next){
+            fa = bNbr->x->arc;
+            csr->head[a] = csr->head[fa];
+            csr->head[fa] = i;
+            csr->pair[a] = fa;
+            csr->pair[fa] = a;
+            csr->res[a] = bNbr->x->flow;
+            a++;
+        }
+    }
+    
+    return csr;
+}
 
-    nbr = findNbr(nbrs, y, dir); /*Se busca*/
-    if(dir == BWD)  /*Es backward, se maneja distinto*/
-        nbr = ((Bedge*)nbr)->x;
+/** Destructor de una CSR.
+ * \param csr La CSR a destruir.
+ * \pre \p csr no es nulo.
+ */
+void nbrhd_csrDestroy(NbrhdCsr csr){
+    assert(csr != NULL);
+    if (csr->owned){
+        free(csr->first);
+        free(csr->mid);
+        free(csr->head);
+        free(csr->pair);
+        free(csr->res);
+    }
+    free(csr);
+}
+
+/** Copia el flujo de cada lado de la CSR a las vecindades de las que se armó.
+ * \param csr   La CSR.
+ * \param nbrs  El mismo arreglo de vecindades con el que se congeló \p csr.
+ * \param n     Cantidad de vecindades en \p nbrs.
+ * \pre \p csr y \p nbrs no son nulos.
+ */
+void nbrhd_sync(NbrhdCsr csr, Nbrhd *nbrs, u64 n){
+    Fedge *fNbr = NULL;     /*Vecino forward de la iteración*/
+    u64 i;                  /*Nodo actual*/
     
-    return ((Fedge*)nbr)->cap;
+    assert(csr != NULL && nbrs != NULL);
+    assert(n == csr->n);
+    for(i = 0; i < n; i++){
+        for(fNbr = nbrs[i]->fNbrs; fNbr != NULL; fNbr = fNbr->hhfNbrs.next)
+            fNbr->flow = csr->res[csr->pair[fNbr->arc]];
+    }
 }
 
-/** Devuelve el valor del flujo del lado que relaciona al nodo ancestro 'x' con 
- * el vecino 'y'.
- * Como pueden haber loops hay que especificar si se esta tratando del lado 'xy'
- * o 'yx'.
- * \param nbrs  El vecindario de 'x'. 
- * \param y     El nombre del vecino.
- * \param dir   Dirección que se encuentra el vecino (lado FWD o BWD).
- * \pre 'y' es vecino de 'x'. 
- * \return  El valor del flujo sobre este lado.
+/** Anula el flujo de todos los lados de la CSR, en una sola pasada por los
+ * arcos: cada arco FWD recupera toda la capacidad del lado y el BWD queda sin
+ * residuo.
+ * \param csr   La CSR.
+ * \pre \p csr no es nulo.
  */
-u64 nbrhd_getFlow(Nbrhd nbrs, u64 y, short int dir){
-    void *nbr = NULL;   /*El vecino*/
+void nbrhd_csrReset(NbrhdCsr csr){
+    u64 a, end;     /*Arco actual y fin de los arcos FWD de 'x'*/
+    u64 x;          /*Nodo actual*/
+    
+    assert(csr != NULL);
+    for(x = 0; x < csr->n; x++){
+        end = csr->mid[x];
+        for(a = csr->first[x]; a < end; a++){
+            csr->res[a] += csr->res[csr->pair[a]];
+            csr->res[csr->pair[a]] = 0;
+        }
+    }
+}
+
+/** Anula el flujo de todos los lados forward de \p nbrs.
+ * \param nbrs  El vecindario del nodo ancestro 'x'.
+ * \pre \p nbrs no es nulo.
+ */
+void nbrhd_resetFlow(Nbrhd nbrs){
+    Fedge *fNbr = NULL;     /*Vecino forward de la iteración*/
     
     assert(nbrs != NULL);
-    assert(dir == FWD || dir == BWD);
+    for(fNbr = nbrs->fNbrs; fNbr != NULL; fNbr = fNbr->hhfNbrs.next)
+        fNbr->flow = 0;
+}
 
-    nbr = findNbr(nbrs, y, dir); /*Se busca*/
-    if(dir == BWD)  /*Es backward, se maneja distinto*/
-        nbr = ((Bedge*)nbr)->x;
+/** Cantidad de lados de la CSR.
+ * \param csr La CSR.
+ * \pre \p csr no es nulo.
+ */
+u64 nbrhd_csrEdges(NbrhdCsr csr){
+    assert(csr != NULL);
+    return csr->m;
+}
+
+/** Cantidad de u64 que ocupa en un archivo una CSR de 'n' nodos y 'm' lados.
+ * Son, en orden, 'first' (n+1), 'mid' (n), 'head', 'pair' y 'res' (2m cada
+ * uno).
+ * \param n Cantidad de nodos.
+ * \param m Cantidad de lados.
+ */
+u64 nbrhd_csrWords(u64 n, u64 m){
+    return (n + 1) + n + 3 * (2 * m);
+}
+
+/** Escribe en \p f los arreglos de la CSR, sin flujo: el residuo de cada arco
+ * FWD es la capacidad de su lado y el de cada BWD es 0. Ocupan
+ * nbrhd_csrWords(n, m) u64, en el orden de la máquina.
+ * Los lados cuyo arco FWD está marcado en \p dead no se escriben: el resto de
+ * los arcos se renumera como si no hubieran estado, así que 'm' pasa a ser la
+ * cantidad de lados no marcados.
+ * \param csr   La CSR.
+ * \param dead  Bitset de un bit por arco con los arcos FWD de los lados que
+ *              no se escriben. NULL si se escriben todos.
+ * \param f     El archivo, abierto para escribir en binario.
+ * \pre \p csr y \p f no son nulos. En \p dead solo se marcan arcos FWD.
+ * \return 1 si se escribió todo, 0 caso contrario.
+ */
+int nbrhd_csrWrite(NbrhdCsr csr, const u64 *dead, FILE *f){
+    u64 buf[CSR_WBUF];  /*u64 por escribir*/
+    u64 len = 0;        /*Cantidad de u64 en 'buf'*/
+    u64 *idx = NULL;    /*Índice de cada arco sin contar los no escritos*/
+    u64 i, a;           /*Nodo y arco actuales*/
+    u64 k = 0;          /*Cantidad de arcos que se escriben*/
+    bool ok = true;     /*No falló ninguna escritura*/
+    
+    assert(csr != NULL && f != NULL);
+    
+    /*idx[2m] queda en la cantidad total, para el 'first' del último nodo*/
+    idx = (u64*) malloc((2*csr->m + 1) * sizeof(u64));
+    assert(idx != NULL);
+    for(a = 0; a < 2*csr->m; a++){
+        idx[a] = k;
+        if (!CSR_DEAD(dead, a) && !CSR_DEAD(dead, csr->pair[a]))
+            k++;
+    }
+    idx[2*csr->m] = k;
+    
+    for(i = 0; i <= csr->n && ok; i++)
+        ok = csr_put(buf, &len, idx[csr->first[i]], f);
+    for(i = 0; i < csr->n && ok; i++)
+        ok = csr_put(buf, &len, idx[csr->mid[i]], f);
+    for(a = 0; a < 2*csr->m && ok; a++){
+        if (!CSR_DEAD(dead, a) && !CSR_DEAD(dead, csr->pair[a]))
+            ok = csr_put(buf, &len, csr->head[a], f);
+    }
+    for(a = 0; a < 2*csr->m && ok; a++){
+        if (!CSR_DEAD(dead, a) && !CSR_DEAD(dead, csr->pair[a]))
+            ok = csr_put(buf, &len, idx[csr->pair[a]], f);
+    }
+    for(i = 0; i < csr->n && ok; i++){
+        for(a = csr->first[i]; a < csr->first[i+1] && ok; a++){
+            if (!CSR_DEAD(dead, a) && !CSR_DEAD(dead, csr->pair[a]))
+                ok = csr_put(buf, &len, a < csr->mid[i] ?
+                             csr->res[a] + csr->res[csr->pair[a]] : 0, f);
+        }
+    }
+    if (ok && len > 0)
+        ok = fwrite(buf, sizeof(u64), len, f) == len;
+    free(idx);
+    return ok ? 1 : 0;
+}
+
+/** Arma una CSR sobre los arreglos que escribió nbrhd_csrWrite(), ya cargados
+ * en memoria (por ejemplo, un archivo mapeado). No los copia: la CSR trabaja
+ * sobre \p data, que debe poder escribirse y vivir más que ella, y al
+ * destruirla no se libera.
+ * \param data  Los nbrhd_csrWords(n, m) u64 escritos.
+ * \param n     Cantidad de nodos.
+ * \param m     Cantidad de lados.
+ * \pre \p data no es nulo y lo escribió nbrhd_csrWrite() con una CSR de \p n
+ *      nodos y \p m lados.
+ * \return Una nueva CSR. El llamador se encarga de destruirla.
+ */
+NbrhdCsr nbrhd_csrMap(u64 *data, u64 n, u64 m){
+    NbrhdCsr csr = NULL;    /*La CSR a armar*/
+    
+    assert(data != NULL);
     
-    return ((Fedge*)nbr)->flow;
+    csr = (NbrhdCsr) malloc(sizeof(struct NbrhdCsrSt));
+    assert(csr != NULL);
+    csr->n = n;
+    csr->m = m;
+    csr->owned = false;
+    csr->first = data;
+    csr->mid = csr->first + (n + 1);
+    csr->head = csr->mid + n;
+    csr->pair = csr->head + 2*m;
+    csr->res = csr->pair + 2*m;
+    assert(csr->first[n] == 2*m);
+    return csr;
+}
+
+/** Controla, en una pasada, que los nbrhd_csrWords(n, m) u64 de \p data sean
+ * arreglos de una CSR como los que escribe nbrhd_csrWrite(). Sirve para no
+ * confiar en un archivo que pudo haberse dañado: si pasa el control, ningún
+ * recorrido de la CSR sale de sus arreglos. \n
+ * Se controla que 'first' empiece en 0, no decrezca y termine en 2m, que
+ * 'mid' quede entre los extremos de cada nodo, que vecinos y opuestos estén en
+ * rango, que cada arco sea el opuesto de su opuesto y lleve de vuelta a su
+ * nodo, que el opuesto de un FWD sea BWD y viceversa, y que los residuos de
+ * los BWD (el flujo) sean nulos.
+ * \param data  Los u64 a controlar.
+ * \param n     Cantidad de nodos.
+ * \param m     Cantidad de lados.
+ * \pre \p data no es nulo y tiene nbrhd_csrWords(n, m) u64.
+ * \return true si se pueden usar con nbrhd_csrMap(). false caso contrario.
+ */
+bool nbrhd_csrValid(const u64 *data, u64 n, u64 m){
+    const u64 *first = data;            /*Primer arco de cada nodo*/
+    const u64 *mid = first + (n + 1);   /*Primer arco BWD de cada nodo*/
+    const u64 *head = mid + n;          /*Vecino de cada arco*/
+    const u64 *pair = head + 2*m;       /*Opuesto de cada arco*/
+    const u64 *res = pair + 2*m;        /*Residuo de cada arco*/
+    u64 x, y;                           /*Nodo dueño del arco y su vecino*/
+    u64 a, b;                           /*Arco y su opuesto*/
+    bool ok;                            /*Pasó los controles. Retorno*/
+    
+    assert(data != NULL);
+    
+    ok = first[0] == 0 && first[n] == 2*m;
+    for(x = 0; x < n && ok; x++)
+        ok = first[x] <= mid[x] && mid[x] <= first[x+1];
+    for(x = 0; x < n && ok; x++){
+        for(a = first[x]; a < first[x+1] && ok; a++){
+            y = head[a];
+            b = pair[a];
+            ok = y < n && b < 2*m && pair[b] == a && head[b] == x &&
+                 first[y] <= b && b < first[y+1] &&
+                 (a < mid[x]) == (b >= mid[y]) &&
+                 (a < mid[x] || res[a] == 0);
+        }
+    }
+    return ok;
+}
+
+/** Arma una CSR con los mismos nodos y arcos que \p csr, pero con sus propios
+ * residuos en \p res, para trabajar sobre otro flujo del mismo network (por
+ * ejemplo, uno por hilo). Los arreglos no se copian ni se liberan al
+ * destruirla: \p csr y \p res deben vivir más que ella.
+ * \param csr   La CSR de la que se toman los nodos y los arcos.
+ * \param res   Arreglo de 2m residuos, uno por arco de \p csr.
+ * \pre \p csr y \p res no son nulos.
+ * \return Una nueva CSR. El llamador se encarga de destruirla.
+ */
+NbrhdCsr nbrhd_csrShare(NbrhdCsr csr, u64 *res){
+    NbrhdCsr copy = NULL;   /*La CSR a armar*/
+    
+    assert(csr != NULL && res != NULL);
+    
+    copy = (NbrhdCsr) malloc(sizeof(struct NbrhdCsrSt));
+    assert(copy != NULL);
+    *copy = *csr;
+    copy->owned = false;
+    copy->res = res;
+    return copy;
+}
+
+/** Primer arco del nodo 'x'.
+ * \param csr La CSR.
+ * \param x   El id del nodo.
+ * \pre \p csr no es nulo y \p x es un id valido.
+ * \return El índice del primer arco de 'x'.
+ */
+u64 nbrhd_arcBegin(NbrhdCsr csr, u64 x){
+    assert(csr != NULL && x < csr->n);
+    return csr->first[x];
+}
+
+/** Fin de los arcos del nodo 'x'.
+ * \param csr La CSR.
+ * \param x   El id del nodo.
+ * \pre \p csr no es nulo y \p x es un id valido.
+ * \return El índice siguiente al último arco de 'x'.
+ */
+u64 nbrhd_arcEnd(NbrhdCsr csr, u64 x){
+    assert(csr != NULL && x < csr->n);
+    return csr->first[x+1];
+}
+
+/** Dirección en la que se encuentra el vecino por el arco 'a' del nodo 'x'.
+ * \param csr La CSR.
+ * \param x   El id del nodo.
+ * \param a   Un arco de 'x'.
+ * \pre \p csr no es nulo y \p a es un arco de 'x'.
+ * \return FWD o BWD.
+ */
+short int nbrhd_arcDir(NbrhdCsr csr, u64 x, u64 a){
+    assert(csr != NULL && x < csr->n);
+    assert(csr->first[x] <= a && a < csr->first[x+1]);
+    return a < csr->mid[x] ? FWD : BWD;
+}
+
+/** Devuelve el id del vecino al que lleva el arco 'a'.
+ * \param csr La CSR.
+ * \param a   El arco.
+ * \pre \p csr no es nulo y \p a es un arco valido.
+ * \return El id del vecino.
+ */
+u64 nbrhd_arcHead(NbrhdCsr csr, u64 a){
+    assert(csr != NULL && a < 2*csr->m);
+    return csr->head[a];
+}
+
+/** Devuelve el arco opuesto a 'a': el del mismo lado, desde su vecino.
+ * Si 'a' lleva de 'x' a 'y', el opuesto lleva de 'y' a 'x', y su residuo es
+ * cuánto flujo puede llegar a 'x' desde 'y' por ese lado.
+ * \param csr La CSR.
+ * \param a   El arco.
+ * \pre \p csr no es nulo y \p a es un arco valido.
+ */
+u64 nbrhd_arcPair(NbrhdCsr csr, u64 a){
+    assert(csr != NULL && a < 2*csr->m);
+    return csr->pair[a];
+}
+
+/** Devuelve la capacidad del lado que representa el arco 'a'.
+ * \param csr La CSR.
+ * \param a   El arco.
+ * \pre \p csr no es nulo y \p a es un arco valido.
+ * \return La capacidad del lado.
+ */
+u64 nbrhd_arcCap(NbrhdCsr csr, u64 a){
+    assert(csr != NULL && a < 2*csr->m);
+    return csr->res[a] + csr->res[csr->pair[a]];
+}
+
+/** Devuelve cuánto flujo se puede enviar por el arco 'a'.
+ * Si el arco es FWD es la capacidad menos el flujo del lado, y si es BWD es
+ * el flujo del lado.
+ * \param csr La CSR.
+ * \param a   El arco.
+ * \pre \p csr no es nulo y \p a es un arco valido.
+ * \return La capacidad residual del arco.
+ */
+u64 nbrhd_arcResidual(NbrhdCsr csr, u64 a){
+    assert(csr != NULL && a < 2*csr->m);
+    return csr->res[a];
+}
+
+/** Envía 'vf' de flujo por el arco 'a'.
+ * Si el arco es FWD aumenta el flujo del lado, y si es BWD lo disminuye.
+ * \param csr   La CSR.
+ * \param a     El arco.
+ * \param vf    El valor de flujo.
+ * \pre \p csr no es nulo y \p a es un arco valido. 
+ *      0 < 'vf' <= nbrhd_arcResidual(csr, a).
+ */
+void nbrhd_arcPush(NbrhdCsr csr, u64 a, u64 vf){
+    assert(csr != NULL && a < 2*csr->m);
+    assert(vf > 0 && vf <= csr->res[a]);
+    
+    csr->res[a] -= vf;
+    csr->res[csr->pair[a]] += vf;
+}
+
+/** Aumenta en 'c' la capacidad del lado que representa el arco FWD 'a', sin
+ * cambiar su flujo: todo el aumento va al residuo del arco FWD.
+ * \param csr   La CSR.
+ * \param a     El arco FWD.
+ * \param c     Capacidad que se agrega.
+ * \pre \p csr no es nulo y \p a es un arco FWD valido.
+ */
+void nbrhd_arcAddCap(NbrhdCsr csr, u64 a, u64 c){
+    assert(csr != NULL && a < 2*csr->m);
+    csr->res[a] += c;
+}
+
+/** Fija en \p c la capacidad del lado que representa el arco FWD \p a.
+ * Si el flujo del lado supera la nueva capacidad, se lo baja a \p c: 'x'
+ * queda con flujo de más y 'y' con flujo de menos, y le toca al llamador
+ * repararlo.
+ * \param csr   La CSR.
+ * \param a     El arco FWD.
+ * \param c     Nueva capacidad del lado.
+ * \pre \p csr no es nulo y \p a es un arco FWD valido.
+ * \return  El flujo que se le quitó al lado (0 si entraba).
+ */
+u64 nbrhd_arcSetCap(NbrhdCsr csr, u64 a, u64 c){
+    u64 flow;           /*Flujo del lado: residuo del arco BWD*/
+    u64 cut = 0;        /*Flujo quitado. Retorno*/
+
+    assert(csr != NULL && a < 2*csr->m);
+    flow = csr->res[csr->pair[a]];
+    if(flow > c){
+        cut = flow - c;
+        flow = c;
+    }
+    csr->res[csr->pair[a]] = flow;
+    csr->res[a] = c - flow;
+    return cut;
+}
+
+/** Como nbrhd_arcResidual(), pero se puede llamar mientras otros hilos
+ * envían flujo con nbrhd_arcPushAtomic().
+ * \param csr   La CSR.
+ * \param a     El arco.
+ * \pre \p csr no es nulo y \p a es un arco valido.
+ */
+u64 nbrhd_arcResidualAtomic(NbrhdCsr csr, u64 a){
+    assert(csr != NULL && a < 2*csr->m);
+    return __atomic_load_n(&csr->res[a], __ATOMIC_RELAXED);
+}
+
+/** Como nbrhd_arcPush(), pero con operaciones atómicas, para que varios hilos
+ * envíen flujo a la vez sin locks.
+ * Sólo el hilo que envía por 'a' disminuye su residuo; los demás sólo pueden
+ * aumentarlo, al enviar por el arco opuesto.
+ * \param csr   La CSR.
+ * \param a     El arco.
+ * \param vf    El valor de flujo.
+ * \pre \p csr no es nulo y \p a es un arco valido. 
+ *      0 < 'vf' <= nbrhd_arcResidual(csr, a), y ningún otro hilo envía flujo
+ *      por 'a' a la vez.
+ */
+void nbrhd_arcPushAtomic(NbrhdCsr csr, u64 a, u64 vf){
+    assert(csr != NULL && a < 2*csr->m);
+    
+    __atomic_fetch_sub(&csr->res[a], vf, __ATOMIC_RELAXED);
+    __atomic_fetch_add(&csr->res[csr->pair[a]], vf, __ATOMIC_RELAXED);
 }
 
 /*
@@ -312,19 +797,20 @@ static void *findNbr(Nbrhd nbrs, u64 y, short int dir){
 
 /** Construye un nuevo vecino forward (Fedge) para el nodo ancestro 'x'. 
  * El valor del flujo se inicia en 0.
+ * \param arena La arena de la que se pide la memoria.
  * \param y Nombre del nuevo vecino forward.
  * \param c Capacidad de envió de flujo a este vecino.
  * \return Puntero a la estructura que representa el nuevo vecino forward.\n
- *         El llamador se encarga de liberarlo.
+ *         Se libera junto con \p arena.
 */
-static Fedge *fedge_create(u64 y, u64 c){
+static Fedge *fedge_create(Arena arena, u64 y, u64 c){
     Fedge *fNbr = NULL;     /*Vecino forward*/
     
-    fNbr = (Fedge *) malloc(sizeof(struct FedgeSt));
-    assert(fNbr != NULL);
+    fNbr = (Fedge *) arena_alloc(arena, sizeof(struct FedgeSt));
     fNbr->y = y;        
     fNbr->cap = c;
     fNbr->flow = 0;
+    fNbr->arc = 0;
     
     return fNbr;
 }
@@ -332,54 +818,40 @@ static Fedge *fedge_create(u64 y, u64 c){
 
 /** Construye un nuevo vecino backward para el nodo ancestro 'x'. 
  * Se vincula a los datos forward respecto a él.
+ * \param arena La arena de la que se pide la memoria.
  * \param y Nombre del nuevo vecino backward.
  * \param fNbr Puntero al lado en donde el nodo 'y' es forward del nodo 'x'.
  * \return Puntero a la estructura que representa el nuevo vecino backward.\n
- *          El llamador se encarga de liberarlo.
+ *          Se libera junto con \p arena.
 */
-static Bedge *bedge_create(u64 y, Fedge *fNbr){
+static Bedge *bedge_create(Arena arena, u64 y, Fedge *fNbr){
     Bedge *bNbr = NULL;     /*Vecino backward*/
     
-    bNbr = (Bedge*) malloc(sizeof(struct BedgeSt));
-    assert(bNbr != NULL);
+    bNbr = (Bedge*) arena_alloc(arena, sizeof(struct BedgeSt));
     bNbr->y = y;          
     bNbr->x = fNbr;
     
     return bNbr;
 }
 
-
-/** Destructor de vecinos forwards.
- * \param fNbrs Puntero a la hash de vecinos forward.
- * \pre \p fNbrs no es nulo.
+/** Agrega \p v a los u64 que junta nbrhd_csrWrite(), y los escribe en \p f
+ * si se llenó \p buf.
+ * \param buf Los u64 por escribir, con lugar para CSR_WBUF.
+ * \param len Cantidad de u64 en \p buf. Vuelve a 0 si se escribieron.
+ * \param v   El u64 a agregar.
+ * \param f   El archivo, abierto para escribir en binario.
+ * \pre \p buf, \p len y \p f no son nulos y *len < CSR_WBUF.
+ * \return true si no falló la escritura. false caso contrario.
  */
-static void fedge_destroy(Fedge *fNbrs){
-    Fedge *felem = NULL;    /*El i-esimo elemento de fNbrs*/
-    Fedge *feTmp = NULL;    /*El i-esimo+1 elemento de fNbrs*/
+static bool csr_put(u64 *buf, u64 *len, u64 v, FILE *f){
+    bool ok = true;     /*No falló la escritura. Retorno*/
     
-    assert(fNbrs != NULL);
-    HASH_ITER(hhfNbrs, fNbrs, felem, feTmp){
-        HASH_DELETE(hhfNbrs, fNbrs, felem);
-        free(felem);
-    }    
-    free(fNbrs);
-    fNbrs = NULL;
-}
-
-
-/** Destructor de vecinos backwards.
- * \param bNbrs Puntero a la hash de vecinos forward.
- * \pre \p bNbrs no es nulo.
- */
-static void bedge_destroy(Bedge *bNbrs){
-    Bedge *belem = NULL;    /*El i-esimo elemento de bNbrs*/
-    Bedge *beTmp = NULL;    /*El i-esimo+1 elemento de bNbrs*/
+    assert(buf != NULL && len != NULL && f != NULL && *len < CSR_WBUF);
     
-    assert(bNbrs != NULL);
-    HASH_ITER(hhbNbrs, bNbrs, belem, beTmp){
-        HASH_DELETE(hhbNbrs, bNbrs, belem);
-        free(belem);
+    buf[(*len)++] = v;
+    if (*len == CSR_WBUF){
+        ok = fwrite(buf, sizeof(u64), *len, f) == *len;
+        *len = 0;
     }
-    free(bNbrs);
-    bNbrs = NULL;
+    return ok;
 }
@@ -1,8 +1,10 @@
 ﻿#ifndef _NBRHD_H
 #define _NBRHD_H
 
+#include <stdio.h>
+#include <stdbool.h>
 #include "_u64.h"
-#include "lado.h"
+#include "_arena.h"
 
 /** \file nbrhd.h
  * Encabezado de nbrhd.c.
@@ -33,79 +35,123 @@
  * Esto se soluciona indicando la dirección, ya que para el nodo 'x' el vecino 
  * por FWD esta representando al lado 'xy', es decir x->y; mientras que el BWD 
  * es al lado 'yx' que justamente viene a ser el FWD y->x.
+ *
+ * Una vez cargado el network, todas las vecindades se pueden congelar en una
+ * representación compacta ((CSR)) sobre la que corren los algoritmos. En ella
+ * los nodos se identifican por un índice ((id)) de 0 a n-1 (la posición de su
+ * vecindad al congelar) y cada nodo 'x' tiene sus arcos ((arc)) contiguos:
+ * primero los FWD y luego los BWD, cada grupo en el orden en que fueron
+ * agregados. Los dos arcos de un mismo lado 'xy' (el FWD en 'x' y el BWD en
+ * 'y') son opuestos: cada uno lleva su capacidad residual, y enviar flujo por
+ * uno la descuenta de él y la suma al otro. El índice de un arco sirve como
+ * referencia al lado para enviar flujo sin volver a buscarlo.
  */
 
 /** \struct Nbrhd 
  * Puntero a la vecindad de un nodo. */
 typedef struct NeighbourhoodSt *Nbrhd;
 
+/** \struct NbrhdCsr
+ * Puntero a la representación compacta (CSR) de todas las vecindades. */
+typedef struct NbrhdCsrSt *NbrhdCsr;
+
 /* dir options:
  * Es la dirección en la que se encuentra un vecino.
  * Una vecindad (Nbrhd) se divide en 2 zonas: FWD y BWD.*/
 #define FWD 1   /**<Forward.*/
 #define BWD -1  /**<Backward.*/
 
-/* Parámetros para nbrhd_getFwd() y nbrhd_getBwd */
-/*'rqst' options: Indica cual es el siguiente vecino que se quiere obtener.*/
-#define FST 0       /**<El primero.*/
-#define NXT 1       /**<El siguiente del último consultado.*/
+/** \struct NbrhdIter
+ * Iterador sobre los vecinos de una dirección de un Nbrhd.
+ * Cada recorrido tiene su propio iterador (en general en el stack del
+ * llamador), por lo que se pueden recorrer varias vecindades a la vez, incluso
+ * desde distintos hilos. Sus campos no deben usarse fuera de nbrhd.c. */
+typedef struct NbrhdIterSt{
+    void *nbr;      /**<Vecino actual (Fedge o Bedge).*/
+    void *next;     /**<Siguiente vecino por visitar.*/
+    short int dir;  /**<Dirección de los vecinos que se recorren.*/
+} NbrhdIter;
 
 
 /*          Funciones
  */
 
 /* Constructor de un nuevo Nbrhd.
+ * El Nbrhd y todos los vecinos que se le agreguen se piden a 'arena', por lo
+ * que viven hasta que se destruya la arena.
+ * arena La arena de la que se pide la memoria.
+ * pre: 'arena' no es nula.
  * return: un Nbrhd vacío.
  */
-Nbrhd nbrhd_create(void);
+Nbrhd nbrhd_create(Arena arena);
 
 /* Destructor de un Nbrhd.
+ * Se liberan las tablas hash de los vecinos. El Nbrhd y los vecinos se liberan
+ * al destruir la arena de la que se pidieron.
  * pre: Nbrhd no es nulo.
  */
 void nbrhd_destroy(Nbrhd nbrhd);
 
 /* Genera el vinculo entre 'x' e 'y' (edge) convirtiéndolos en vecinos.
  * La relación es 'xy': 'y' vecino forward de 'x'; 'x' vecino backward de 'y'.
- * pre: 'x', 'y', 'edge' no son nulos.
+ * Si el lado ya existía (lados paralelos) se suman las capacidades.
+ * pre: 'x', 'y' no son nulos.
  * x Vecindario del nodo 'x'.
  * y Vecindario del nodo 'y'.
- * edge Lado 'xy' con su capacidad y flujo.
+ * xName Nombre del nodo 'x'.
+ * yName Nombre del nodo 'y'.
+ * c Capacidad del lado 'xy'.
  */
-void nbrhd_addEdge(Nbrhd x, Nbrhd y, Lado edge);
+void nbrhd_addEdge(Nbrhd x, Nbrhd y, u64 xName, u64 yName, u64 c);
 
-/* Busca el siguiente vecino forward.
- * La petición de búsqueda puede ser por el primer nodo (FST) de la tabla, 
- * o bien por el siguiente(NXT) del ultimo pedido. 
- * Si existe, almacena el nombre en 'y'.
- * 
- * NOTE Tener en cuenta la documentación sobre las opciones de los parámetros.
- * Verlo como un iterador de consultas a una tabla.
- * 
- * nbrs  El vecindario del nodo ancestro 'x'. 
- * rqst  Si se pide el primero 'FST' o un siguiente 'NXT'.
- * y     Variable en la que se almacena el nombre del vecino encontrado.
- * pre: 'nbrs' e 'y' no son nulos y 'rqst' es una opción valida (FST o NXT).
- * return: 1 Si se encontró y se almacenó en 'y' un vecino.
- *         0 Caso contrario.
+/* Indica si existe el lado 'xy'.
+ * nbrs  Vecindario del nodo 'x'.
+ * y     Nombre del nodo 'y'.
+ * pre: 'nbrs' no es nulo.
+ * return: true si 'y' es vecino forward de 'x', false caso contrario.
  */
-int nbrhd_getFwd(Nbrhd nbrs, int rqst, u64 *y);
+bool nbrhd_hasEdge(Nbrhd nbrs, u64 y);
 
-/* Busca el siguiente vecino backward.
- * La petición de búsqueda puede ser por el primer nodo (FST) de la tabla, 
- * o bien por el siguiente(NXT) del ultimo pedido. 
- * Si existe almacena el nombre en 'y'.
- * 
- * NOTE Tener en cuenta la documentación sobre las opciones de los parámetros.
- * Verlo como un iterador de consultas a una tabla.
- * 
- * nbrs  El vecindario del nodo ancestro 'x'. 
- * rqst  Si se pide el primero 'FST' o un siguiente 'NXT'.
- * y     Variable en la que se almacena el nombre del vecino encontrado.
- * pre: 'nbrs' e 'y' no son nulos y 'rqst' es una opción valida (FST o NXT)
+/* Fija en 'c' la capacidad del lado 'xy', sin tocar su flujo.
+ * nbrs  Vecindario del nodo 'x'.
+ * y     Nombre del nodo 'y'.
+ * c     Nueva capacidad del lado.
+ * pre: 'nbrs' no es nulo y el lado 'xy' existe.
+ */
+void nbrhd_setCap(Nbrhd nbrs, u64 y, u64 c);
+
+/* Quita el lado 'xy'. Los demás vecinos mantienen su orden.
+ * pre: 'x', 'y' no son nulos y el lado 'xy' existe.
+ * x Vecindario del nodo 'x'.
+ * y Vecindario del nodo 'y'.
+ * xName Nombre del nodo 'x'.
+ * yName Nombre del nodo 'y'.
+ */
+void nbrhd_removeEdge(Nbrhd x, Nbrhd y, u64 xName, u64 yName);
+
+/* Inicia un recorrido por los vecinos de 'nbrs' en la dirección 'dir'.
+ * Los vecinos se visitan en el orden en que fueron agregados.
+ * it    El iterador a iniciar.
+ * nbrs  El vecindario del nodo ancestro 'x'.
+ * dir   Dirección de los vecinos a recorrer (FWD o BWD).
+ * pre: 'it' y 'nbrs' no son nulos. 'dir' es FWD o BWD.
+ */
+void nbrhd_iterInit(NbrhdIter *it, Nbrhd nbrs, short int dir);
+
+/* Avanza al siguiente vecino del recorrido.
+ * Si existe, almacena su nombre en 'y' y queda como vecino actual.
+ * it  El iterador.
+ * y   Variable en la que se almacena el nombre del vecino encontrado.
+ * pre: 'it' fue iniciado con nbrhd_iterInit() e 'y' no es nulo.
  * return: 1 Si se encontró y se almacenó en 'y' un vecino.
  *         0 Caso contrario.
  */
-int nbrhd_getBwd(Nbrhd nbrs, int rqst, u64 *y);
+int nbrhd_iterNext(NbrhdIter *it, u64 *y);
+
+/* Devuelve el flujo del lado con el vecino actual del recorrido.
+ * pre: La última llamada a nbrhd_iterNext() con 'it' devolvió 1.
+ */
+u64 nbrhd_iterFlow(const NbrhdIter *it);
 
 /* Se aumenta el flujo para con el vecino 'y' por 'vf' cantidad. 
  * Si 'y' es un vecino BWD, el valor del flujo se disminuye por 'vf' cantidad.
@@ -116,28 +162,179 @@ int nbrhd_getBwd(Nbrhd nbrs, int rqst, u64 *y);
  * return: Valor del nuevo flujo que se esta enviando entre 'x' e 'y'.*/
 u64 nbrhd_increaseFlow(Nbrhd nbrs, u64 y, short int dir, u64 vf); 
 
-/* Devuelve la capacidad del lado que relaciona al nodo ancestro 'x' con el 
- * vecino 'y'.
- * Como pueden haber loops hay que especificar si se esta tratando del lado 'xy'
- * o 'yx'.
- * nbrs  El vecindario del nodo ancestro 'x'. 
- * y     El nombre del vecino.
- * dir   Dirección que se encuentra el vecino (lado FWD o BWD).
- * pre: 'y' es vecino de 'x'. 
- * return:  La capacidad sobre este lado.
+
+/*          Funciones de la representación compacta (CSR)
  */
-u64 nbrhd_getCap(Nbrhd nbrs, u64 y, short int dir);  
 
-/* Devuelve el valor del flujo del lado que relaciona al nodo ancestro 'x' con 
- * el vecino 'y'.
- * Como pueden haber loops hay que especificar si se esta tratando del lado 'xy'
- * o 'yx'.
- * nbrs  El vecindario de 'x'. 
- * y     El nombre del vecino.
- * dir   Dirección que se encuentra el vecino (lado FWD o BWD).
- * pre: 'y' es vecino de 'x'. 
- * return:  El valor del flujo sobre este lado.
+/* Congela las vecindades de un network en una representación CSR.
+ * El nodo de la vecindad nbrs[i] pasa a identificarse con el id 'i'. Los
+ * flujos y capacidades actuales de cada lado se copian a la CSR; a partir de
+ * aquí el flujo se manipula sobre ella y se devuelve con nbrhd_sync().
+ * nbrs  Arreglo con las vecindades de todos los nodos del network.
+ * n     Cantidad de vecindades en 'nbrs'.
+ * pre: 'nbrs' no es nulo y todo vecino de una vecindad de 'nbrs' tiene su
+ *      vecindad en 'nbrs'.
+ * return: Una nueva CSR. El llamador se encarga de destruirla.
+ */
+NbrhdCsr nbrhd_freeze(Nbrhd *nbrs, u64 n);
+
+/* Destructor de una CSR.
+ * pre: 'csr' no es nulo.
+ */
+void nbrhd_csrDestroy(NbrhdCsr csr);
+
+/* Copia el flujo de cada lado de la CSR a las vecindades de las que se armó.
+ * csr   La CSR.
+ * nbrs  El mismo arreglo de vecindades con el que se congeló 'csr'.
+ * n     Cantidad de vecindades en 'nbrs'.
+ * pre: 'csr' y 'nbrs' no son nulos.
+ */
+void nbrhd_sync(NbrhdCsr csr, Nbrhd *nbrs, u64 n);
+
+/* Anula el flujo de todos los lados de la CSR, en una sola pasada.
+ * pre: 'csr' no es nulo.
+ */
+void nbrhd_csrReset(NbrhdCsr csr);
+
+/* Anula el flujo de todos los lados forward de 'nbrs'.
+ * pre: 'nbrs' no es nulo.
+ */
+void nbrhd_resetFlow(Nbrhd nbrs);
+
+/* Cantidad de lados de la CSR.
+ * pre: 'csr' no es nulo.
+ */
+u64 nbrhd_csrEdges(NbrhdCsr csr);
+
+/* Cantidad de u64 que ocupa en un archivo una CSR de 'n' nodos y 'm' lados.
+ */
+u64 nbrhd_csrWords(u64 n, u64 m);
+
+/* Escribe en 'f' los arreglos de la CSR, sin flujo: el residuo de cada arco
+ * FWD es la capacidad de su lado y el de cada BWD es 0. Ocupan
+ * nbrhd_csrWords(n, m) u64, en el orden de la máquina. Los lados cuyo arco FWD
+ * está marcado en 'dead' no se escriben, y 'm' es la cantidad de los demás.
+ * csr   La CSR.
+ * dead  Bitset de un bit por arco con los arcos FWD de los lados que no se
+ *       escriben. NULL si se escriben todos.
+ * f     El archivo, abierto para escribir en binario.
+ * pre: 'csr' y 'f' no son nulos. En 'dead' solo se marcan arcos FWD.
+ * return: 1 si se escribió todo, 0 caso contrario.
+ */
+int nbrhd_csrWrite(NbrhdCsr csr, const u64 *dead, FILE *f);
+
+/* Arma una CSR sobre los arreglos que escribió nbrhd_csrWrite(), ya cargados
+ * en memoria (por ejemplo, un archivo mapeado). No los copia: la CSR trabaja
+ * sobre 'data', que debe poder escribirse y vivir más que ella, y al
+ * destruirla no se libera.
+ * data  Los nbrhd_csrWords(n, m) u64 escritos.
+ * n     Cantidad de nodos.
+ * m     Cantidad de lados.
+ * pre: 'data' no es nulo y lo escribió nbrhd_csrWrite() con una CSR de 'n'
+ *      nodos y 'm' lados.
+ * return: Una nueva CSR. El llamador se encarga de destruirla.
+ */
+NbrhdCsr nbrhd_csrMap(u64 *data, u64 n, u64 m);
+
+/* Controla, en una pasada, que los nbrhd_csrWords(n, m) u64 de 'data' sean
+ * arreglos de una CSR como los que escribe nbrhd_csrWrite(): arcos de cada
+ * nodo contiguos y en orden, vecinos y opuestos dentro de rango, cada arco
+ * opuesto de su opuesto, FWD con BWD, y residuos BWD nulos.
+ * data  Los u64 a controlar.
+ * n     Cantidad de nodos.
+ * m     Cantidad de lados.
+ * pre: 'data' no es nulo y tiene nbrhd_csrWords(n, m) u64.
+ * return: true si se pueden usar con nbrhd_csrMap(). false caso contrario.
+ */
+bool nbrhd_csrValid(const u64 *data, u64 n, u64 m);
+
+/* Arma una CSR con los mismos nodos y arcos que 'csr', pero con sus propios
+ * residuos en 'res', para trabajar sobre otro flujo del mismo network. Los
+ * arreglos no se copian ni se liberan al destruirla.
+ * csr   La CSR de la que se toman los nodos y los arcos.
+ * res   Arreglo de 2m residuos, uno por arco de 'csr'.
+ * pre: 'csr' y 'res' no son nulos y viven más que la nueva CSR.
+ * return: Una nueva CSR. El llamador se encarga de destruirla.
+ */
+NbrhdCsr nbrhd_csrShare(NbrhdCsr csr, u64 *res);
+
+/* Primer arco del nodo 'x'.
+ * pre: 'csr' no es nulo y 'x' es un id valido.
+ * return: El índice del primer arco de 'x'.
+ */
+u64 nbrhd_arcBegin(NbrhdCsr csr, u64 x);
+
+/* Fin de los arcos del nodo 'x'.
+ * pre: 'csr' no es nulo y 'x' es un id valido.
+ * return: El índice siguiente al último arco de 'x'.
+ */
+u64 nbrhd_arcEnd(NbrhdCsr csr, u64 x);
+
+/* Dirección en la que se encuentra el vecino por el arco 'a' del nodo 'x'.
+ * pre: 'csr' no es nulo y 'a' es un arco de 'x'.
+ * return: FWD o BWD.
+ */
+short int nbrhd_arcDir(NbrhdCsr csr, u64 x, u64 a);
+
+/* Devuelve el id del vecino al que lleva el arco 'a'.
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ */
+u64 nbrhd_arcHead(NbrhdCsr csr, u64 a);
+
+/* Devuelve el arco opuesto a 'a': el del mismo lado, desde su vecino.
+ * Si 'a' lleva de 'x' a 'y', el opuesto lleva de 'y' a 'x', y su residuo es
+ * cuánto flujo puede llegar a 'x' desde 'y' por ese lado.
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ */
+u64 nbrhd_arcPair(NbrhdCsr csr, u64 a);
+
+/* Devuelve la capacidad del lado que representa el arco 'a'.
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ */
+u64 nbrhd_arcCap(NbrhdCsr csr, u64 a);
+
+/* Devuelve cuánto flujo se puede enviar por el arco 'a'.
+ * Si el arco es FWD es la capacidad menos el flujo del lado, y si es BWD es
+ * el flujo del lado.
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ */
+u64 nbrhd_arcResidual(NbrhdCsr csr, u64 a);
+
+/* Envía 'vf' de flujo por el arco 'a'.
+ * Si el arco es FWD aumenta el flujo del lado, y si es BWD lo disminuye.
+ * csr   La CSR.
+ * a     El arco.
+ * vf    El valor de flujo.
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ *      0 < 'vf' <= nbrhd_arcResidual(csr, a).
+ */
+void nbrhd_arcPush(NbrhdCsr csr, u64 a, u64 vf);
+
+/* Aumenta en 'c' la capacidad del lado que representa el arco FWD 'a', sin
+ * cambiar su flujo.
+ * pre: 'csr' no es nulo y 'a' es un arco FWD valido.
+ */
+void nbrhd_arcAddCap(NbrhdCsr csr, u64 a, u64 c);
+
+/* Fija en 'c' la capacidad del lado que representa el arco FWD 'a'. Si el
+ * flujo del lado no entra, se lo baja a 'c'.
+ * pre: 'csr' no es nulo y 'a' es un arco FWD valido.
+ * return: el flujo que se le quitó al lado (0 si entraba).
+ */
+u64 nbrhd_arcSetCap(NbrhdCsr csr, u64 a, u64 c);
+
+/* Como nbrhd_arcResidual(), pero se puede llamar mientras otros hilos
+ * envían flujo con nbrhd_arcPushAtomic().
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ */
+u64 nbrhd_arcResidualAtomic(NbrhdCsr csr, u64 a);
+
+/* Como nbrhd_arcPush(), pero con operaciones atómicas, para que varios hilos
+ * envíen flujo a la vez sin locks.
+ * pre: 'csr' no es nulo y 'a' es un arco valido.
+ *      0 < 'vf' <= nbrhd_arcResidual(csr, a), y ningún otro hilo envía flujo
+ *      por 'a' a la vez.
  */
-u64 nbrhd_getFlow(Nbrhd nbrs, u64 y, short int dir); 
+void nbrhd_arcPushAtomic(NbrhdCsr csr, u64 a, u64 vf);
 
 #endif
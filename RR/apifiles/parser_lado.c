@@ -1,10 +1,13 @@
 ﻿#include "parser_lado.h"
 #include "_u64.h"
 #include <assert.h>
+#include <stdlib.h>
 
 #define EOL "\n"            /**<Para indicador de final de linea.*/
 #define WHITE_SPACE " "     /**<Para indicador de espacio en blanco.*/
 
+#define SCAN_BUF (1 << 16) /**<Tamaño del bloque que lee un LadoScanner.*/
+
 /*flags para next_bstring*/
 #define ACCEPT 1   /**<Solo se aceptan char contenidos en str.*/
 #define EXCEPT 0   /**<Se acepta cualquier char que no este contenido en str.*/
@@ -14,6 +17,21 @@
 static int parse_argument(Lexer *input, u64 *arg);
 static bstring next_bstring(Lexer *input, int flag, const char *str);
 static bool is_theNextChar(Lexer *input, const char *ch);
+static int scan_peek(LadoScanner sc);
+static bool scan_isBlank(int ch);
+static int scan_argument(LadoScanner sc, u64 *n);
+
+/** Estructura de un lector en bloque de lados.
+ * Los caracteres por leer son [p, end) del buffer, que se vuelve a llenar 
+ * desde el archivo cuando se acaban. Si se lee de memoria, [p, end) son los
+ * datos que quedan y no hay buffer.
+ */
+struct LadoScannerSt{
+    FILE *input;        /**<Archivo del que se lee. NULL si se lee de memoria.*/
+    char *buf;          /**<Bloque leído del archivo.*/
+    const char *p;      /**<Siguiente caracter por leer.*/
+    const char *end;    /**<Fin de los caracteres leídos.*/
+};
 
 /** Lee todo un Lado de \p input hasta llegar a un fin de línea o de archivo.
  *  Se asegura que se consumió input hasta el primer error o hasta completar 
@@ -40,7 +58,10 @@ Lado parser_lado(Lexer *input){
         if (its_ok && is_theNextChar(input, WHITE_SPACE))
             /*Asigno el 3er argumento parseado a 'cap'*/
             its_ok = parse_argument(input, &cap);   
-    }
+        else
+            its_ok = PARSER_ERR;    /*Falta la capacidad*/
+    }else
+        its_ok = PARSER_ERR;        /*Falta el nodo 'y'*/
     /*Si se parseo todo bien, creo el nuevo Lado con los valores*/
     if (its_ok){
         result = lado_new(x, y, cap);
@@ -80,6 +101,103 @@ int parser_nextLine(Lexer *input){
 }
 
 
+/** Crea un lector en bloque de lados sobre el archivo \p f.
+ * El lector lee \p f por adelantado, por lo que al terminar su posición puede
+ * estar más allá de la última linea parseada.
+ * \param f  El archivo abierto del que se leen los lados.
+ * \pre f!=NULL.
+ * \return Un nuevo LadoScanner. El llamador se encarga de destruirlo.
+ */
+LadoScanner parser_scannerNew(FILE *f){
+    LadoScanner sc = NULL;  /*El nuevo lector*/
+    
+    assert(f != NULL);
+    sc = (LadoScanner) malloc(sizeof(struct LadoScannerSt));
+    assert(sc != NULL);
+    sc->buf = (char*) malloc(SCAN_BUF);
+    assert(sc->buf != NULL);
+    sc->input = f;
+    sc->p = sc->buf;
+    sc->end = sc->buf;
+    return sc;
+}
+
+/** Crea un lector en bloque de lados sobre los \p len bytes de \p data.
+ * Sirve para parsear un archivo mapeado en memoria, o una parte de él: el fin
+ * de los datos se toma como fin de archivo.
+ * \param data  Los datos a parsear. Deben existir mientras se use el lector.
+ * \param len   Cantidad de bytes de \p data.
+ * \pre data!=NULL || len==0.
+ * \return Un nuevo LadoScanner. El llamador se encarga de destruirlo.
+ */
+LadoScanner parser_scannerNewMem(const char *data, size_t len){
+    LadoScanner sc = NULL;  /*El nuevo lector*/
+    
+    assert(data != NULL || len == 0);
+    sc = (LadoScanner) malloc(sizeof(struct LadoScannerSt));
+    assert(sc != NULL);
+    sc->input = NULL;
+    sc->buf = NULL;
+    sc->p = data;
+    sc->end = data + len;
+    return sc;
+}
+
+/** Destructor de un LadoScanner. No cierra el archivo.
+ * \param sc El lector a destruir.
+ * \pre sc!=NULL.
+ */
+void parser_scannerDestroy(LadoScanner sc){
+    assert(sc != NULL);
+    free(sc->buf);
+    free(sc);
+}
+
+/** Lee la siguiente linea como un lado 'xy' de capacidad 'c', consumiendo su
+ * fin de línea.
+ * \note Replica lo que aceptan parser_lado() y parser_nextLine() con el
+ * Lexer, incluso en los casos raros: los blancos son ' ' y '\0' (strchr()
+ * encuentra el '\0' en cualquier conjunto), un '\0' dentro de un número lo
+ * corta pero se consume junto con él, y un número que no entra en un u64 se
+ * satura como lo hace sscanf().
+ * \param sc  El lector.
+ * \param x   Donde se almacena el nodo 'x'.
+ * \param y   Donde se almacena el nodo 'y'.
+ * \param c   Donde se almacena la capacidad.
+ * \pre sc, x, y, c no son nulos.
+ * \return  PARSER_OK si la linea es un lado valido, sin basura. \n
+ *          PARSER_ERR caso contrario (o fin de archivo).
+ */
+int parser_scanLado(LadoScanner sc, u64 *x, u64 *y, u64 *c){
+    int its_ok = PARSER_ERR;    /*Chequea que el parse va bien*/
+    int ch;                     /*Siguiente caracter*/
+    
+    assert(sc != NULL && x != NULL && y != NULL && c != NULL);
+    
+    /*Los argumentos van separados por al menos un blanco*/
+    its_ok = scan_argument(sc, x);
+    if (its_ok && scan_isBlank(scan_peek(sc))){
+        sc->p++;
+        its_ok = scan_argument(sc, y);
+        if (its_ok && scan_isBlank(scan_peek(sc))){
+            sc->p++;
+            its_ok = scan_argument(sc, c);
+        }else
+            its_ok = PARSER_ERR;
+    }else
+        its_ok = PARSER_ERR;
+    /*Solo puede haber blancos antes del fin de línea (o de archivo)*/
+    if (its_ok){
+        while (scan_isBlank(ch = scan_peek(sc)))
+            sc->p++;
+        if (ch == '\n')
+            sc->p++;
+        else if (ch != EOF)
+            its_ok = PARSER_ERR;
+    }
+    return its_ok;
+}
+
 /*INTERNAS*/
 
 
@@ -188,3 +306,69 @@ static bool is_theNextChar(Lexer *input, const char *ch){
     }
     return result;
 }
+
+/** Devuelve el siguiente caracter del lector, sin consumirlo.
+ * Si no quedan caracteres en el buffer, lo vuelve a llenar desde el archivo.
+ * \param sc El lector.
+ * \pre sc!=NULL.
+ * \return El caracter (como unsigned char) o EOF si se terminó el archivo.
+ */
+static int scan_peek(LadoScanner sc){
+    size_t len;     /*Cantidad de caracteres leídos del archivo*/
+    
+    assert(sc != NULL);
+    if (sc->p == sc->end && sc->input != NULL){
+        len = fread(sc->buf, 1, SCAN_BUF, sc->input);
+        sc->p = sc->buf;
+        sc->end = sc->buf + len;
+    }
+    return sc->p < sc->end ? (unsigned char) *sc->p : EOF;
+}
+
+/** Decide si un caracter es un blanco entre argumentos.
+ * \param ch El caracter.
+ * \return True si es ' ' o '\0'.
+ */
+static bool scan_isBlank(int ch){
+    return ch == ' ' || ch == '\0';
+}
+
+/** Parsea un argumento, saltando los blancos anteriores.
+ * Los caracteres que se lean deben ser dígitos para que el argumento sea válido.
+ * \param sc El lector.
+ * \param n  El argumento parseado resultante.
+ * \pre sc!=NULL.
+ * \return  Si no hubo error, asigna el argumento parseado en 'n' y retorna 
+ *          PARSER_OK. \n
+ *          Si hubo error, no asigna nada a 'n' y retorna PARSER_ERR.
+*/
+static int scan_argument(LadoScanner sc, u64 *n){
+    int result = PARSER_ERR;    /*Retorno (error al menos que haya dígitos)*/
+    int ch;                     /*Siguiente caracter*/
+    u64 val = 0;                /*Valor acumulado*/
+    u64 d;                      /*Valor del dígito actual*/
+    bool cut = false;           /*Se encontró un '\0' dentro del número*/
+    
+    assert(sc != NULL);
+    while (scan_isBlank(ch = scan_peek(sc)))
+        sc->p++;
+    if (ch >= '0' && ch <= '9')
+        result = PARSER_OK;
+    /*Consumo todo lo que el Lexer tomaría como dígito*/
+    while (result && ((ch >= '0' && ch <= '9') || ch == '\0')){
+        if (ch == '\0')
+            cut = true;
+        else if (!cut){
+            d = (u64)(ch - '0');
+            if (val > (u64_MAX - d) / 10)
+                val = u64_MAX;    /*Saturado*/
+            else
+                val = val * 10 + d;
+        }
+        sc->p++;
+        ch = scan_peek(sc);
+    }
+    if (result)
+        *n = val;
+    return result;
+}
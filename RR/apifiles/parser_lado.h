@@ -11,6 +11,7 @@
     Ejemplo: 2 4 6\n2 4 54\n321321 321321 4888\nEOF
    \endverbatim
 */
+#include <stddef.h>
 #include "_lexer.h"
 #include "lado.h"
 
@@ -40,4 +41,51 @@ Lado parser_lado(Lexer *input);
  */
 int parser_nextLine (Lexer *input);
 
+
+/*          Lectura en bloque
+ * Para cargar un network entero no hace falta un Lexer (ni un Lado) por 
+ * linea: un LadoScanner lee el archivo de a bloques y parsea los números a 
+ * mano, aceptando exactamente las mismas lineas que parser_lado() seguido de
+ * parser_nextLine().
+ */
+
+/** \struct LadoScanner
+ * Puntero a un lector en bloque de lados. */
+typedef struct LadoScannerSt *LadoScanner;
+
+/* Crea un lector en bloque de lados sobre el archivo 'f'.
+ * El lector lee 'f' por adelantado, por lo que al terminar su posición puede
+ * estar más allá de la última linea parseada.
+ * f  El archivo abierto del que se leen los lados.
+ * pre: f!=NULL.
+ * return: Un nuevo LadoScanner. El llamador se encarga de destruirlo.
+ */
+LadoScanner parser_scannerNew(FILE *f);
+
+/* Crea un lector en bloque de lados sobre los 'len' bytes de 'data'.
+ * Sirve para parsear un archivo mapeado en memoria, o una parte de él: el fin
+ * de los datos se toma como fin de archivo.
+ * data  Los datos a parsear. Deben existir mientras se use el lector.
+ * len   Cantidad de bytes de 'data'.
+ * pre: data!=NULL || len==0.
+ * return: Un nuevo LadoScanner. El llamador se encarga de destruirlo.
+ */
+LadoScanner parser_scannerNewMem(const char *data, size_t len);
+
+/* Destructor de un LadoScanner. No cierra el archivo.
+ * pre: sc!=NULL.
+ */
+void parser_scannerDestroy(LadoScanner sc);
+
+/* Lee la siguiente linea como un lado 'xy' de capacidad 'c', consumiendo su
+ * fin de línea.
+ * sc  El lector.
+ * x, y, c  Donde se almacenan los valores leídos.
+ * pre: sc, x, y, c no son nulos.
+ * return:  PARSER_OK si la linea es un lado valido, sin basura.
+ *          PARSER_ERR caso contrario (o fin de archivo). Luego de un error no
+ *          tiene sentido seguir leyendo.
+ */
+int parser_scanLado(LadoScanner sc, u64 *x, u64 *y, u64 *c);
+
 #endif
@@ -0,0 +1,797 @@
+﻿#define _POSIX_C_SOURCE 200809L   /*pthread_barrier_t*/
+
+#include <assert.h>
+#include <limits.h>
+#include <stdbool.h>
+#include <stdlib.h>
+#include <pthread.h>
+#include <sched.h>
+#include "preflow.h"
+
+#define NIL u64_MAX         /**<Valor nulo de un id de nodo.*/
+#define LVL_NIL -1          /**<Altura nula de un nodo, como en bfs.c.*/
+#define PF_ALPHA 6          /**<Peso de los nodos en el trabajo entre dos
+                            global relabel.*/
+#define PF_BETA 12          /**<Trabajo fijo de un relabel, además de
+                            recorrer los arcos del nodo.*/
+#define PF_LINE 64          /**<Tamaño de una linea de cache.*/
+#define PF_DEQUE 64         /**<Capacidad inicial de la cola de un hilo.*/
+#define PF_STEAL 32         /**<Máximo de nodos que se roban por vez.*/
+
+/** Estado de una corrida de push-relabel.
+ * Los nodos con altura menor a 'n' están en listas por altura ('bucket'),
+ * que sirven para detectar un gap. Los nodos activos están en pilas por
+ * altura (regla HL) o en una cola (regla FIFO, y en la segunda etapa).
+ */
+typedef struct PreflowSt{
+    NbrhdCsr csr;       /**<CSR del network.*/
+    u64 n;              /**<Cantidad de nodos.*/
+    u64 s;              /**<Id de la fuente.*/
+    u64 t;              /**<Id del resumidero.*/
+    short int rule;     /**<Regla para elegir el próximo nodo activo.*/
+    u64 *d;             /**<Altura de cada nodo.*/
+    u64 *e;             /**<Exceso de cada nodo.*/
+    u64 *cur;           /**<Arco actual de cada nodo.*/
+    u64 *bFirst;        /**<Primer nodo de cada altura menor a 'n'.*/
+    u64 *bNext;         /**<Siguiente nodo de la misma altura.*/
+    u64 *bPrev;         /**<Anterior nodo de la misma altura.*/
+    u64 dMax;           /**<Mayor altura con nodos, menor a 'n'.*/
+    u64 *aFirst;        /**<Tope de la pila de activos de cada altura (HL).*/
+    u64 *aNext;         /**<Siguiente activo en la pila o en la cola.*/
+    u64 aMax;           /**<Mayor altura con activos, en la regla HL.*/
+    u64 qHead, qTail;   /**<Extremos de la cola de activos.*/
+    u64 work;           /**<Trabajo desde el último global relabel.*/
+    u64 *bfs;           /**<Cola de los BFS hacia atrás.*/
+} Preflow;
+
+typedef struct PreflowParSt PreflowPar;
+
+/** Datos propios de cada hilo de la versión en paralelo.
+ * Cada hilo tiene su cola de nodos activos. El dueño agrega y saca por el
+ * final ('bot'); un hilo sin trabajo le roba la mitad desde el principio
+ * ('top'). La cola tiene su propio mutex, pero empujar flujo y levantar
+ * alturas no toma ningún lock.
+ * Se rellena hasta ocupar una linea de cache, como en bfs.c.
+ */
+typedef struct PfWorkerSt{
+    PreflowPar *P;          /**<La corrida de la que es parte el hilo.*/
+    unsigned int k;         /**<Índice del hilo. El 0 es el que llama.*/
+    pthread_mutex_t mu;     /**<Protege la cola.*/
+    u64 *buf;               /**<Nodos activos, de 'top' a 'bot'.*/
+    u64 top, bot;           /**<Extremos de la cola en 'buf'.*/
+    u64 size;               /**<Capacidad de 'buf'.*/
+    char pad[PF_LINE];
+} PfWorker;
+
+/** Estado de una corrida de push-relabel en paralelo.
+ * Los hilos trabajan por épocas. Al empezar cada una, el hilo 0 recalcula
+ * todas las alturas (con el BFS en paralelo de bfs.c) y reparte los nodos
+ * activos entre las colas; luego todos descargan nodos hasta que no quedan
+ * activos, o hasta que el trabajo hecho pide otro global relabel.
+ * Las alturas, los excesos y los residuos se leen y escriben con operaciones
+ * atómicas. Un nodo está en a lo sumo una cola, y lo descarga un solo hilo a
+ * la vez: lo agrega quien le lleva el exceso de 0 a positivo, y lo suelta
+ * quien se lo deja en 0.
+ */
+struct PreflowParSt{
+    NbrhdCsr csr;           /**<CSR del network.*/
+    u64 n;                  /**<Cantidad de nodos.*/
+    u64 s;                  /**<Id de la fuente.*/
+    u64 t;                  /**<Id del resumidero.*/
+    Bfs bfs;                /**<Buscador para los global relabel.*/
+    unsigned int threads;   /**<Cantidad de hilos.*/
+    pthread_t *tid;         /**<Hilos lanzados, del 1 al threads-1.*/
+    pthread_barrier_t epoch;/**<Sincronización entre épocas.*/
+    PfWorker *w;            /**<Datos de cada hilo.*/
+    int *h;                 /**<Altura de cada nodo.*/
+    u64 *e;                 /**<Exceso de cada nodo.*/
+    u64 active;             /**<Nodos en colas o descargándose.*/
+    u64 work;               /**<Trabajo desde el último global relabel.*/
+    u64 threshold;          /**<Trabajo entre dos global relabel.*/
+    bool stop;              /**<La época debe terminar.*/
+    bool finished;          /**<No quedan activos tras un global relabel.*/
+};
+
+static void pf_init(Preflow *P, NbrhdCsr csr, u64 n, u64 s, u64 t, 
+                    short int rule);
+static void pf_destroy(Preflow *P);
+static void pf_globalRelabel(Preflow *P);
+static void pf_discharge(Preflow *P, u64 v);
+static bool pf_relabel(Preflow *P, u64 v);
+static void pf_gap(Preflow *P, u64 k);
+static void pf_returnExcess(Preflow *P);
+static void bucket_add(Preflow *P, u64 v);
+static void bucket_remove(Preflow *P, u64 v);
+static void active_add(Preflow *P, u64 v);
+static u64 active_pop(Preflow *P);
+static void *ppf_worker(void *arg);
+static void ppf_epochs(PfWorker *w);
+static void ppf_globalRelabel(PreflowPar *P);
+static void ppf_discharge(PfWorker *w, u64 v);
+static void deque_push(PfWorker *w, u64 v);
+static u64 deque_pop(PfWorker *w);
+static u64 deque_steal(PfWorker *w, PfWorker *victim);
+
+
+/** Lleva el flujo de la CSR de 's' a 't' a un flujo maximal.
+ * Parte del flujo que ya tenga la CSR, que puede ser nulo.
+ * \param csr   La CSR del network.
+ * \param n     Cantidad de nodos de \p csr.
+ * \param s     Id del nodo fuente.
+ * \param t     Id del nodo resumidero.
+ * \param rule  PREFLOW_HL o PREFLOW_FIFO.
+ * \pre \p csr no es nulo. \p s y \p t son ids validos y distintos.
+ * \return Cuánto aumentó el valor del flujo.
+ */
+u64 preflow_maxFlow(NbrhdCsr csr, u64 n, u64 s, u64 t, short int rule){
+    Preflow P;          /*Estado de la corrida*/
+    u64 a, end;         /*Arco actual y fin de los arcos de 's'*/
+    u64 r;              /*Residuo de un arco de 's'*/
+    u64 y;              /*Vecino de 's'*/
+    u64 v;              /*Nodo activo a descargar*/
+    u64 threshold;      /*Trabajo entre dos global relabel*/
+    u64 result;         /*Retorno*/
+    
+    assert(csr != NULL && s < n && t < n && s != t);
+    assert(rule == PREFLOW_HL || rule == PREFLOW_FIFO);
+    pf_init(&P, csr, n, s, t, rule);
+    
+    /*Se satura todo lo que sale de 's'*/
+    end = nbrhd_arcEnd(csr, s);
+    for(a = nbrhd_arcBegin(csr, s); a < end; a++){
+        r = nbrhd_arcResidual(csr, a);
+        y = nbrhd_arcHead(csr, a);
+        if (r > 0 && y != s){
+            nbrhd_arcPush(csr, a, r);
+            P.e[y] += r;
+        }
+    }
+    /*Primera etapa: preflujo maximal*/
+    threshold = PF_ALPHA * n + nbrhd_arcEnd(csr, n - 1);
+    pf_globalRelabel(&P);
+    v = active_pop(&P);
+    while(v != NIL){
+        /*Un gap pudo dejarlo sin camino a 't' mientras esperaba*/
+        if (P.d[v] < n)
+            pf_discharge(&P, v);
+        if (P.work > threshold)
+            pf_globalRelabel(&P);
+        v = active_pop(&P);
+    }
+    result = P.e[t];
+    /*Segunda etapa: el exceso que no llegó a 't' vuelve a 's'*/
+    pf_returnExcess(&P);
+    
+    pf_destroy(&P);
+    return result;
+}
+
+/** Lleva el flujo de la CSR de 's' a 't' a un flujo maximal, usando tantos
+ * hilos como \p bfs.
+ * Es push-relabel sin locks: cada hilo descarga un nodo a la vez, empujando
+ * su exceso hacia el vecino más bajo al que tiene residuo, o levantándolo una
+ * más que ese vecino si no está más abajo. Como los demás hilos pueden estar
+ * cambiando las alturas, el vecino se busca de nuevo en cada paso. Con
+ * alturas viejas se puede empujar de más, pero nunca se rompe la capacidad de
+ * un arco ni se pierde exceso.
+ * La segunda etapa, devolver a 's' el exceso que no llegó a 't', es la misma
+ * que en preflow_maxFlow().
+ * \param csr   La CSR del network.
+ * \param n     Cantidad de nodos de \p csr.
+ * \param s     Id del nodo fuente.
+ * \param t     Id del nodo resumidero.
+ * \param bfs   Buscador con el que se hacen los global relabel.
+ * \pre \p csr y \p bfs no son nulos. \p s y \p t son ids validos y distintos.
+ *      \p n no supera INT_MAX.
+ * \return Cuánto aumentó el valor del flujo.
+ */
+u64 preflow_maxFlowPar(NbrhdCsr csr, u64 n, u64 s, u64 t, Bfs bfs){
+    PreflowPar P;       /*Estado de la corrida*/
+    Preflow Q;          /*Estado de la segunda etapa*/
+    u64 a, end;         /*Arco actual y fin de los arcos de 's'*/
+    u64 r;              /*Residuo de un arco de 's'*/
+    u64 y;              /*Vecino de 's'*/
+    u64 i;              /*Id del nodo actual*/
+    unsigned int k;     /*Índice de hilo*/
+    int err;            /*Error de pthread*/
+    u64 result;         /*Retorno*/
+    
+    assert(csr != NULL && bfs != NULL && s < n && t < n && s != t);
+    assert(n <= INT_MAX);
+    P.csr = csr;
+    P.n = n;
+    P.s = s;
+    P.t = t;
+    P.bfs = bfs;
+    P.threads = bfs_threads(bfs);
+    P.tid = (pthread_t*) malloc(P.threads * sizeof(pthread_t));
+    P.w = (PfWorker*) malloc(P.threads * sizeof(PfWorker));
+    P.h = (int*) malloc(n * sizeof(int));
+    P.e = (u64*) calloc(n, sizeof(u64));
+    assert(P.tid != NULL && P.w != NULL && P.h != NULL && P.e != NULL);
+    P.threshold = PF_ALPHA * n + nbrhd_arcEnd(csr, n - 1);
+    err = pthread_barrier_init(&P.epoch, NULL, P.threads);
+    assert(err == 0);
+    for(k = 0; k < P.threads; k++){
+        P.w[k].P = &P;
+        P.w[k].k = k;
+        P.w[k].buf = NULL;
+        P.w[k].top = 0;
+        P.w[k].bot = 0;
+        P.w[k].size = 0;
+        err = pthread_mutex_init(&P.w[k].mu, NULL);
+        assert(err == 0);
+    }
+    
+    /*Se satura todo lo que sale de 's'*/
+    end = nbrhd_arcEnd(csr, s);
+    for(a = nbrhd_arcBegin(csr, s); a < end; a++){
+        r = nbrhd_arcResidual(csr, a);
+        y = nbrhd_arcHead(csr, a);
+        if (r > 0 && y != s){
+            nbrhd_arcPush(csr, a, r);
+            P.e[y] += r;
+        }
+    }
+    /*Primera etapa: preflujo maximal, con todos los hilos*/
+    for(k = 1; k < P.threads; k++){
+        err = pthread_create(&P.tid[k], NULL, ppf_worker, &P.w[k]);
+        assert(err == 0);
+    }
+    ppf_epochs(&P.w[0]);
+    for(k = 1; k < P.threads; k++)
+        pthread_join(P.tid[k], NULL);
+    result = P.e[t];
+    
+    /*Segunda etapa: el exceso que no llegó a 't' vuelve a 's'*/
+    pf_init(&Q, csr, n, s, t, PREFLOW_FIFO);
+    for(i = 0; i < n; i++)
+        Q.e[i] = P.e[i];
+    pf_returnExcess(&Q);
+    pf_destroy(&Q);
+    
+    for(k = 0; k < P.threads; k++){
+        pthread_mutex_destroy(&P.w[k].mu);
+        free(P.w[k].buf);
+    }
+    pthread_barrier_destroy(&P.epoch);
+    free(P.tid);
+    free(P.w);
+    free(P.h);
+    free(P.e);
+    (void) err;
+    return result;
+}
+
+/** Pide la memoria de una corrida y la inicia sin exceso en ningún nodo.
+ * \param P     El estado a iniciar.
+ * \param csr   La CSR del network.
+ * \param n     Cantidad de nodos de \p csr.
+ * \param s     Id del nodo fuente.
+ * \param t     Id del nodo resumidero.
+ * \param rule  Regla para elegir el próximo nodo activo.
+ */
+static void pf_init(Preflow *P, NbrhdCsr csr, u64 n, u64 s, u64 t, 
+                    short int rule){
+    u64 i;  /*Id del nodo actual*/
+    
+    P->csr = csr;
+    P->n = n;
+    P->s = s;
+    P->t = t;
+    P->rule = rule;
+    P->d = (u64*) malloc(n * sizeof(u64));
+    P->e = (u64*) malloc(n * sizeof(u64));
+    P->cur = (u64*) malloc(n * sizeof(u64));
+    P->bFirst = (u64*) malloc(n * sizeof(u64));
+    P->bNext = (u64*) malloc(n * sizeof(u64));
+    P->bPrev = (u64*) malloc(n * sizeof(u64));
+    P->aFirst = (u64*) malloc(2 * n * sizeof(u64));
+    P->aNext = (u64*) malloc(n * sizeof(u64));
+    P->bfs = (u64*) malloc(n * sizeof(u64));
+    assert(P->d != NULL && P->e != NULL && P->cur != NULL);
+    assert(P->bFirst != NULL && P->bNext != NULL && P->bPrev != NULL);
+    assert(P->aFirst != NULL && P->aNext != NULL && P->bfs != NULL);
+    for(i = 0; i < n; i++){
+        P->e[i] = 0;
+        P->cur[i] = nbrhd_arcBegin(csr, i);
+    }
+    P->work = 0;
+}
+
+/** Libera la memoria de una corrida.
+ * \param P El estado de la corrida.
+ */
+static void pf_destroy(Preflow *P){
+    free(P->d);
+    free(P->e);
+    free(P->cur);
+    free(P->bFirst);
+    free(P->bNext);
+    free(P->bPrev);
+    free(P->aFirst);
+    free(P->aNext);
+    free(P->bfs);
+}
+
+/** Recalcula todas las alturas como la distancia exacta a 't' por arcos con
+ * residuo, y arma de nuevo las listas por altura y los activos.
+ * Los nodos que no llegan a 't' quedan con altura 'n'.
+ * \param P El estado de la corrida.
+ */
+static void pf_globalRelabel(Preflow *P){
+    u64 head = 0, tail = 0; /*Extremos de la cola del BFS*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'w'*/
+    u64 v, w;               /*Nodo por revisar y nodo que se expande*/
+    u64 i;                  /*Id del nodo actual*/
+    
+    for(i = 0; i < P->n; i++){
+        P->d[i] = P->n;
+        P->bFirst[i] = NIL;
+        P->aFirst[i] = NIL;
+        P->cur[i] = nbrhd_arcBegin(P->csr, i);
+    }
+    P->dMax = 0;
+    P->aMax = 0;
+    P->qHead = NIL;
+    P->qTail = NIL;
+    P->work = 0;
+    
+    P->d[P->t] = 0;
+    P->bfs[tail++] = P->t;
+    while(head < tail){
+        w = P->bfs[head++];
+        bucket_add(P, w);
+        end = nbrhd_arcEnd(P->csr, w);
+        for(a = nbrhd_arcBegin(P->csr, w); a < end; a++){
+            v = nbrhd_arcHead(P->csr, a);
+            /*El arco opuesto lleva de 'v' a 'w'*/
+            if (P->d[v] == P->n && v != P->s &&
+                nbrhd_arcResidual(P->csr, nbrhd_arcPair(P->csr, a)) > 0){
+                P->d[v] = P->d[w] + 1;
+                P->bfs[tail++] = v;
+            }
+        }
+    }
+    /*Se activan en el orden del BFS, de menor a mayor altura*/
+    for(i = 1; i < tail; i++){
+        if (P->e[P->bfs[i]] > 0)
+            active_add(P, P->bfs[i]);
+    }
+}
+
+/** Descarga el nodo 'v': empuja su exceso por arcos admisibles (con residuo
+ * y hacia un vecino de altura una menor) y lo levanta cuando no le quedan.
+ * Termina cuando no tiene exceso, o cuando su altura llega a 'n' (en la
+ * primera etapa) y ya no puede llegar a 't'.
+ * \param P El estado de la corrida.
+ * \param v Id del nodo activo.
+ */
+static void pf_discharge(Preflow *P, u64 v){
+    u64 a, end;             /*Arco actual y fin de los arcos de 'v'*/
+    u64 w;                  /*Vecino de 'v'*/
+    u64 r;                  /*Residuo del arco actual*/
+    u64 delta;              /*Flujo que se empuja*/
+    bool alive = true;      /*'v' todavía puede descargarse*/
+    
+    end = nbrhd_arcEnd(P->csr, v);
+    while(P->e[v] > 0 && alive){
+        a = P->cur[v];
+        if (a == end){
+            alive = pf_relabel(P, v);
+        }else{
+            w = nbrhd_arcHead(P->csr, a);
+            r = nbrhd_arcResidual(P->csr, a);
+            if (r > 0 && P->d[v] == P->d[w] + 1){
+                delta = P->e[v] < r ? P->e[v] : r;
+                nbrhd_arcPush(P->csr, a, delta);
+                P->e[v] -= delta;
+                /*Si no tenía exceso, pasa a estar activo*/
+                if (P->e[w] == 0 && w != P->s && w != P->t)
+                    active_add(P, w);
+                P->e[w] += delta;
+            }else
+                P->cur[v] = a + 1;
+        }
+    }
+}
+
+/** Levanta el nodo 'v' a una más que el vecino más bajo al que tiene un arco
+ * con residuo.
+ * En la primera etapa la altura se limita a 'n', y si 'v' era el último nodo
+ * de su altura se aplica la heurística de gap.
+ * \param P El estado de la corrida.
+ * \param v Id del nodo.
+ * \return true si 'v' puede seguir descargándose.\n
+ *         false si en la primera etapa quedó con altura 'n'.
+ */
+static bool pf_relabel(Preflow *P, u64 v){
+    u64 a, begin, end;      /*Arco actual, primero y fin de los arcos de 'v'*/
+    u64 dMin = u64_MAX;     /*Menor altura de un vecino alcanzable*/
+    u64 old;                /*Altura anterior de 'v'*/
+    u64 w;                  /*Vecino de 'v'*/
+    bool result = true;     /*Retorno*/
+    
+    old = P->d[v];
+    begin = nbrhd_arcBegin(P->csr, v);
+    end = nbrhd_arcEnd(P->csr, v);
+    P->work += PF_BETA + (end - begin);
+    for(a = begin; a < end; a++){
+        w = nbrhd_arcHead(P->csr, a);
+        if (nbrhd_arcResidual(P->csr, a) > 0 && P->d[w] < dMin)
+            dMin = P->d[w];
+    }
+    P->cur[v] = begin;
+    
+    if (old < P->n){
+        /*Primera etapa*/
+        bucket_remove(P, v);
+        if (P->bFirst[old] == NIL){
+            /*Gap: nadie queda a altura 'old', lo de arriba no llega a 't'*/
+            pf_gap(P, old);
+            P->d[v] = P->n;
+        }else
+            P->d[v] = dMin < P->n - 1 ? dMin + 1 : P->n;
+        if (P->d[v] < P->n)
+            bucket_add(P, v);
+        result = P->d[v] < P->n;
+    }else{
+        /*Segunda etapa: siempre hay un camino con residuo de vuelta a 's'*/
+        assert(dMin != u64_MAX);
+        P->d[v] = dMin + 1;
+    }
+    return result;
+}
+
+/** Heurística de gap: ningún nodo tiene altura 'k', así que los nodos más
+ * altos que 'k' no pueden llegar a 't' y pasan a tener altura 'n'.
+ * \param P El estado de la corrida.
+ * \param k Altura que quedó vacía.
+ */
+static void pf_gap(Preflow *P, u64 k){
+    u64 l;      /*Altura actual*/
+    u64 v;      /*Nodo de altura 'l'*/
+    
+    for(l = k + 1; l <= P->dMax; l++){
+        for(v = P->bFirst[l]; v != NIL; v = P->bNext[v])
+            P->d[v] = P->n;
+        P->bFirst[l] = NIL;
+    }
+    P->dMax = k > 0 ? k - 1 : 0;
+}
+
+/** Segunda etapa: devuelve a 's' el exceso de los nodos que no llegan a 't'.
+ * Las alturas pasan a ser 'n' más la distancia a 's' por arcos con residuo, y
+ * se descargan los nodos con exceso en orden FIFO. Un nodo con exceso siempre
+ * tiene un camino con residuo de vuelta a 's', y ninguno a 't', así que el
+ * flujo que llegó a 't' no cambia.
+ * \param P El estado de la corrida.
+ */
+static void pf_returnExcess(Preflow *P){
+    u64 head = 0, tail = 0; /*Extremos de la cola del BFS*/
+    u64 a, end;             /*Arco actual y fin de los arcos de 'w'*/
+    u64 v, w;               /*Nodo por revisar y nodo que se expande*/
+    u64 i;                  /*Id del nodo actual*/
+    
+    for(i = 0; i < P->n; i++){
+        P->d[i] = 2 * P->n;
+        P->cur[i] = nbrhd_arcBegin(P->csr, i);
+    }
+    P->rule = PREFLOW_FIFO;
+    P->qHead = NIL;
+    P->qTail = NIL;
+    
+    P->d[P->s] = P->n;
+    P->bfs[tail++] = P->s;
+    while(head < tail){
+        w = P->bfs[head++];
+        end = nbrhd_arcEnd(P->csr, w);
+        for(a = nbrhd_arcBegin(P->csr, w); a < end; a++){
+            v = nbrhd_arcHead(P->csr, a);
+            if (P->d[v] == 2 * P->n && v != P->t &&
+                nbrhd_arcResidual(P->csr, nbrhd_arcPair(P->csr, a)) > 0){
+                P->d[v] = P->d[w] + 1;
+                P->bfs[tail++] = v;
+            }
+        }
+    }
+    for(i = 0; i < P->n; i++){
+        if (P->e[i] > 0 && i != P->s && i != P->t)
+            active_add(P, i);
+    }
+    v = active_pop(P);
+    while(v != NIL){
+        pf_discharge(P, v);
+        v = active_pop(P);
+    }
+}
+
+/** Agrega 'v' a la lista de su altura, que es menor a 'n'.
+ * \param P El estado de la corrida.
+ * \param v Id del nodo.
+ */
+static void bucket_add(Preflow *P, u64 v){
+    u64 k = P->d[v];    /*Altura de 'v'*/
+    
+    P->bPrev[v] = NIL;
+    P->bNext[v] = P->bFirst[k];
+    if (P->bFirst[k] != NIL)
+        P->bPrev[P->bFirst[k]] = v;
+    P->bFirst[k] = v;
+    if (k > P->dMax)
+        P->dMax = k;
+}
+
+/** Quita 'v' de la lista de su altura.
+ * \param P El estado de la corrida.
+ * \param v Id del nodo.
+ */
+static void bucket_remove(Preflow *P, u64 v){
+    if (P->bPrev[v] != NIL)
+        P->bNext[P->bPrev[v]] = P->bNext[v];
+    else
+        P->bFirst[P->d[v]] = P->bNext[v];
+    if (P->bNext[v] != NIL)
+        P->bPrev[P->bNext[v]] = P->bPrev[v];
+}
+
+/** Agrega 'v' a los nodos activos.
+ * \param P El estado de la corrida.
+ * \param v Id de un nodo con exceso que no está activo.
+ */
+static void active_add(Preflow *P, u64 v){
+    if (P->rule == PREFLOW_HL){
+        P->aNext[v] = P->aFirst[P->d[v]];
+        P->aFirst[P->d[v]] = v;
+        if (P->d[v] > P->aMax)
+            P->aMax = P->d[v];
+    }else{
+        P->aNext[v] = NIL;
+        if (P->qTail != NIL)
+            P->aNext[P->qTail] = v;
+        else
+            P->qHead = v;
+        P->qTail = v;
+    }
+}
+
+/** Saca el próximo nodo activo, según la regla de la corrida.
+ * \param P El estado de la corrida.
+ * \return El id del nodo, o NIL si no quedan activos.
+ */
+static u64 active_pop(Preflow *P){
+    u64 v = NIL;    /*Retorno*/
+    
+    if (P->rule == PREFLOW_HL){
+        while(P->aFirst[P->aMax] == NIL && P->aMax > 0)
+            P->aMax--;
+        v = P->aFirst[P->aMax];
+        if (v != NIL)
+            P->aFirst[P->aMax] = P->aNext[v];
+    }else{
+        v = P->qHead;
+        if (v != NIL){
+            P->qHead = P->aNext[v];
+            if (P->qHead == NIL)
+                P->qTail = NIL;
+        }
+    }
+    return v;
+}
+
+/** Cuerpo de los hilos lanzados por preflow_maxFlowPar().
+ * \param arg Los datos del hilo, un PfWorker*.
+ */
+static void *ppf_worker(void *arg){
+    ppf_epochs((PfWorker*) arg);
+    return NULL;
+}
+
+/** Trabajo de un hilo en la primera etapa: épocas de descargas separadas por
+ * global relabel, hasta que no quedan nodos activos.
+ * \param w Los datos del hilo.
+ */
+static void ppf_epochs(PfWorker *w){
+    PreflowPar *P = w->P;   /*La corrida*/
+    bool finished = false;  /*No quedan activos*/
+    unsigned int k;         /*Hilo al que se intenta robar*/
+    u64 v;                  /*Nodo activo a descargar*/
+    
+    while(!finished){
+        pthread_barrier_wait(&P->epoch);
+        if (w->k == 0)
+            ppf_globalRelabel(P);
+        pthread_barrier_wait(&P->epoch);
+        finished = P->finished;
+        k = w->k;
+        while(!finished && !__atomic_load_n(&P->stop, __ATOMIC_RELAXED) &&
+              __atomic_load_n(&P->active, __ATOMIC_ACQUIRE) > 0){
+            v = deque_pop(w);
+            /*Sin trabajo propio, se roba a los demás hilos por turno*/
+            if (v == NIL && P->threads > 1){
+                k = (k + 1) % P->threads;
+                if (k != w->k)
+                    v = deque_steal(w, &P->w[k]);
+            }
+            if (v != NIL)
+                ppf_discharge(w, v);
+            else
+                sched_yield();
+        }
+    }
+}
+
+/** Recalcula todas las alturas como la distancia exacta a 't' por arcos con
+ * residuo, y reparte los nodos activos entre las colas de los hilos.
+ * Lo hace el hilo 0 mientras los demás esperan en la barrera.
+ * \param P La corrida.
+ */
+static void ppf_globalRelabel(PreflowPar *P){
+    int n = (int) P->n;     /*Altura de los nodos que no llegan a 't'*/
+    unsigned int k;         /*Hilo al que se da el próximo activo*/
+    u64 i;                  /*Id del nodo actual*/
+    
+    for(i = 0; i < P->n; i++)
+        P->h[i] = LVL_NIL;
+    /*'s' queda sin distancia, y por lo tanto en 'n'*/
+    bfs_toSink(P->bfs, P->csr, P->n, P->h, P->t, P->s);
+    for(k = 0; k < P->threads; k++){
+        P->w[k].top = 0;
+        P->w[k].bot = 0;
+    }
+    P->active = 0;
+    k = 0;
+    for(i = 0; i < P->n; i++){
+        if (P->h[i] == LVL_NIL)
+            P->h[i] = n;
+        else if (P->e[i] > 0 && i != P->t){
+            deque_push(&P->w[k], i);
+            P->active++;
+            k = (k + 1) % P->threads;
+        }
+    }
+    P->work = 0;
+    P->stop = false;
+    P->finished = P->active == 0;
+}
+
+/** Descarga el nodo 'v' hasta dejarlo sin exceso, o hasta que su altura
+ * llega a 'n' y ya no puede llegar a 't'. En ambos casos lo suelta.
+ * Cada paso busca el vecino más bajo al que 'v' tiene residuo. Si está más
+ * abajo que 'v' le empuja todo lo que puede, y si no levanta a 'v' una más
+ * que él. Los vecinos que pasan a tener exceso van a la cola del hilo.
+ * \param w Los datos del hilo.
+ * \param v Id de un nodo activo que el hilo tiene.
+ */
+static void ppf_discharge(PfWorker *w, u64 v){
+    PreflowPar *P = w->P;   /*La corrida*/
+    int n = (int) P->n;     /*Altura de los nodos que no llegan a 't'*/
+    u64 a, begin, end;      /*Arco actual, primero y fin de los arcos de 'v'*/
+    u64 aMin = NIL;         /*Arco hacia el vecino más bajo*/
+    int hMin;               /*Altura del vecino más bajo*/
+    int hy;                 /*Altura de un vecino*/
+    u64 ev;                 /*Exceso de 'v'*/
+    u64 r;                  /*Residuo de un arco*/
+    u64 delta;              /*Flujo que se empuja*/
+    u64 y;                  /*Vecino de 'v'*/
+    u64 work = 0;           /*Trabajo hecho*/
+    bool owned = true;      /*El hilo todavía tiene a 'v'*/
+    
+    begin = nbrhd_arcBegin(P->csr, v);
+    end = nbrhd_arcEnd(P->csr, v);
+    /*Pudo quedar en 'n' y recibir exceso por un empuje con alturas viejas*/
+    if (P->h[v] >= n)
+        owned = false;
+    while(owned && !__atomic_load_n(&P->stop, __ATOMIC_RELAXED)){
+        ev = __atomic_load_n(&P->e[v], __ATOMIC_ACQUIRE);
+        hMin = n;
+        for(a = begin; a < end; a++){
+            if (nbrhd_arcResidualAtomic(P->csr, a) > 0){
+                y = nbrhd_arcHead(P->csr, a);
+                hy = __atomic_load_n(&P->h[y], __ATOMIC_RELAXED);
+                if (hy < hMin){
+                    hMin = hy;
+                    aMin = a;
+                }
+            }
+        }
+        work += PF_BETA + (end - begin);
+        if (hMin < P->h[v]){
+            /*Solo este hilo disminuye el residuo de 'aMin' y el exceso de 'v'*/
+            r = nbrhd_arcResidualAtomic(P->csr, aMin);
+            delta = ev < r ? ev : r;
+            y = nbrhd_arcHead(P->csr, aMin);
+            nbrhd_arcPushAtomic(P->csr, aMin, delta);
+            /*El vecino se cuenta como activo antes de soltar a 'v'*/
+            if (__atomic_fetch_add(&P->e[y], delta, __ATOMIC_ACQ_REL) == 0 &&
+                y != P->s && y != P->t){
+                __atomic_fetch_add(&P->active, 1, __ATOMIC_ACQ_REL);
+                deque_push(w, y);
+            }
+            if (__atomic_fetch_sub(&P->e[v], delta, __ATOMIC_ACQ_REL) == delta)
+                owned = false;
+        }else{
+            /*Solo este hilo cambia la altura de 'v'*/
+            __atomic_store_n(&P->h[v], hMin < n - 1 ? hMin + 1 : n, 
+                             __ATOMIC_RELAXED);
+            if (P->h[v] >= n)
+                owned = false;
+        }
+    }
+    if (!owned)
+        __atomic_fetch_sub(&P->active, 1, __ATOMIC_ACQ_REL);
+    if (__atomic_add_fetch(&P->work, work, __ATOMIC_RELAXED) > P->threshold)
+        __atomic_store_n(&P->stop, true, __ATOMIC_RELAXED);
+}
+
+/** Agrega 'v' al final de la cola del hilo.
+ * \param w Los datos del hilo.
+ * \param v Id del nodo.
+ */
+static void deque_push(PfWorker *w, u64 v){
+    u64 i;      /*Posición en la cola*/
+    
+    pthread_mutex_lock(&w->mu);
+    if (w->bot == w->size){
+        if (w->top > 0){
+            /*Se corre al principio lo que no se robó*/
+            for(i = w->top; i < w->bot; i++)
+                w->buf[i - w->top] = w->buf[i];
+            w->bot -= w->top;
+            w->top = 0;
+        }else{
+            w->size = w->size > 0 ? 2 * w->size : PF_DEQUE;
+            w->buf = (u64*) realloc(w->buf, w->size * sizeof(u64));
+            assert(w->buf != NULL);
+        }
+    }
+    w->buf[w->bot++] = v;
+    pthread_mutex_unlock(&w->mu);
+}
+
+/** Saca el último nodo de la cola del hilo.
+ * \param w Los datos del hilo.
+ * \return El id del nodo, o NIL si la cola está vacía.
+ */
+static u64 deque_pop(PfWorker *w){
+    u64 v = NIL;    /*Retorno*/
+    
+    pthread_mutex_lock(&w->mu);
+    if (w->bot > w->top)
+        v = w->buf[--w->bot];
+    if (w->bot == w->top){
+        w->top = 0;
+        w->bot = 0;
+    }
+    pthread_mutex_unlock(&w->mu);
+    return v;
+}
+
+/** Roba la mitad de la cola de otro hilo (a lo sumo PF_STEAL nodos), desde el
+ * principio. El primer nodo robado se devuelve y el resto pasa a la cola del
+ * ladrón. Nunca se toman los dos mutex a la vez.
+ * \param w      Los datos del hilo que roba.
+ * \param victim Los datos del hilo al que se roba.
+ * \return El id del primer nodo robado, o NIL si la cola estaba vacía.
+ */
+static u64 deque_steal(PfWorker *w, PfWorker *victim){
+    u64 stolen[PF_STEAL];   /*Nodos robados*/
+    u64 cnt;                /*Cantidad de nodos robados*/
+    u64 i;                  /*Posición en 'stolen'*/
+    u64 v = NIL;            /*Retorno*/
+    
+    pthread_mutex_lock(&victim->mu);
+    cnt = (victim->bot - victim->top + 1) / 2;
+    if (cnt > PF_STEAL)
+        cnt = PF_STEAL;
+    for(i = 0; i < cnt; i++)
+        stolen[i] = victim->buf[victim->top++];
+    pthread_mutex_unlock(&victim->mu);
+    
+    if (cnt > 0){
+        v = stolen[0];
+        for(i = 1; i < cnt; i++)
+            deque_push(w, stolen[i]);
+    }
+    return v;
+}
@@ -0,0 +1,63 @@
+﻿#ifndef _PREFLOW_H
+#define _PREFLOW_H
+
+#include "_u64.h"
+#include "nbrhd.h"
+#include "bfs.h"
+
+/** \file preflow.h
+ * Flujo maximal por push-relabel sobre la CSR de un network.
+ * En lugar de buscar caminos, cada nodo acumula un exceso de flujo y lo
+ * empuja por arcos con residuo hacia vecinos de altura ((label)) una menor;
+ * si no puede, se levanta su altura (relabel). La altura de un nodo es una
+ * cota inferior de su distancia a 't'.
+ * Se trabaja en dos etapas. En la primera se arma un preflujo maximal:
+ * todo lo que puede llegar a 't' llega, y los nodos cuya altura alcanza 'n'
+ * ya no pueden llegar a 't' y se dejan con su exceso. En la segunda ese exceso
+ * se devuelve a 's', y queda un flujo.
+ * Se usan las dos heurísticas de siempre: cada tanto se recalculan todas las
+ * alturas con un BFS hacia atrás desde 't' (global relabel), y si ningún nodo
+ * queda con una altura 'k' los nodos más altos que 'k' ya no llegan a 't' y
+ * pasan directamente a 'n' (gap).
+ */
+
+/* Reglas para elegir el próximo nodo activo (con exceso) a descargar.*/
+#define PREFLOW_HL 1    /**<El de mayor altura (highest label).*/
+#define PREFLOW_FIFO 2  /**<En el orden en que se activaron (FIFO).*/
+
+
+/*          Funciones
+ */
+
+/* Lleva el flujo de la CSR de 's' a 't' a un flujo maximal.
+ * Parte del flujo que ya tenga la CSR, que puede ser nulo.
+ * csr   La CSR del network.
+ * n     Cantidad de nodos de 'csr'.
+ * s     Id del nodo fuente.
+ * t     Id del nodo resumidero.
+ * rule  PREFLOW_HL o PREFLOW_FIFO.
+ * pre: 'csr' no es nulo. 's' y 't' son ids validos y distintos.
+ * return: Cuánto aumentó el valor del flujo.
+ */
+u64 preflow_maxFlow(NbrhdCsr csr, u64 n, u64 s, u64 t, short int rule);
+
+/* Lleva el flujo de la CSR de 's' a 't' a un flujo maximal, usando tantos
+ * hilos como 'bfs'.
+ * Es push-relabel sin locks: cada hilo descarga un nodo a la vez y los
+ * excesos y residuos se actualizan con operaciones atómicas. Los nodos activos
+ * se reparten en colas por hilo, y un hilo sin trabajo le roba a los demás.
+ * Cada tanto se recalculan todas las alturas con el BFS en paralelo de 'bfs'.
+ * El valor del flujo es el mismo que el de preflow_maxFlow(), pero el flujo
+ * de cada lado puede ser otro, y cambiar de una corrida a otra.
+ * csr   La CSR del network.
+ * n     Cantidad de nodos de 'csr'.
+ * s     Id del nodo fuente.
+ * t     Id del nodo resumidero.
+ * bfs   Buscador con el que se hacen los global relabel.
+ * pre: 'csr' y 'bfs' no son nulos. 's' y 't' son ids validos y distintos.
+ *      'n' no supera INT_MAX.
+ * return: Cuánto aumentó el valor del flujo.
+ */
+u64 preflow_maxFlowPar(NbrhdCsr csr, u64 n, u64 s, u64 t, Bfs bfs);
+
+#endif
@@ -10,6 +10,10 @@
 
 /*MACROS PARA MANEJAR LOS parámetros DE ENTRADA.*/
 /*Flags.*/
+#define GOMORY_HU   0b100000000000  /**<Se calcula el árbol de Gomory-Hu.*/
+#define QUERIES      0b10000000000  /**<Se responden los pares (s,t) de -q.*/
+#define SNAPSHOT      0b1000000000  /**<El network de entrada es un snapshot.*/
+#define PRUNE          0b100000000  /**<Activa la poda del network de niveles.*/
 #define DONT_DINIC      0b10000000  /**<Permite (o no) que se realice dinic.*/
 #define S_OK            0b01000000  /**<'s' fue pasado como parámetro.*/
 #define T_OK            0b00100000  /**<'t' fue pasado como parámetro.*/
@@ -18,16 +22,26 @@
 #define FLOW            0b00000100  /**<Activa el muestreo de flujo.*/
 #define CUT             0b00000010  /**<Activa el muestreo de corte.*/
 #define FLOW_V          0b00000001  /**<Activa el muestreo de valor del flujo.*/
+#define MAX_THREADS     1024        /**<Máximo de hilos que se aceptan con -j.*/
 /*Macros para manipular flags.*/
 #define SET_FLAG(f) STATUS |= f         /**<Setea un bit de flag en STATUS en 1.*/
 #define UNSET_FLAG(f) STATUS &= ~f      /**<Setea un bit de flag en STATUS en 0.*/
 #define CLEAR_FLAG() 0b00000000         /**<Pone todas las flags en 0.*/
-#define IS_SET_FLAG(f) (STATUS & f) > 0 /**<Consulta si una flag esta activa.*/
+#define IS_SET_FLAG(f) ((STATUS & (f)) > 0) /**<Consulta si una flag esta activa.*/
 
 /*FUNCIONES ESTATICAS.*/
 static void load_from_stdin(DovahkiinP dova);
 static void print_help(char * programName);
-static short int parametersChecker(int argc, char *argv[], u64 * source, u64 * sink);
+static short int parametersChecker(int argc, char *argv[], u64 * source, u64 * sink,
+                                   char ** input, char ** save,
+                                   char ** queries, char ** dump,
+                                   int * dumpFormat, unsigned int * threads,
+                                   int * engine);
+static int run_query(DovahkiinP dova, short int STATUS, int engine);
+static void run_queries(DovahkiinP dova, short int STATUS, int engine,
+                        char * queries, char * programName);
+static void run_gomoryHu(DovahkiinP dova, short int STATUS, char * queries,
+                         char * programName);
 static void print_dinicTime(float time);
 static bool isu64(char * sU64);
 
@@ -37,15 +51,8 @@ static bool isu64(char * sU64);
  * \param dova El dova donde se cargaran los lados.
  */
 void load_from_stdin(DovahkiinP dova){
-
-    Lado lado = LadoNulo;/*Lado leído. Caso vacío se retorna LadoNulo.*/
-    int load_ok = 0;/*Indica si el lado se pudo cargar.*/
-    
     assert(dova != NULL);
-    do{
-        lado = LeerUnLado();
-        load_ok = CargarUnLado(dova, lado);
-    }while(load_ok);
+    CargarDesdeArchivo(dova, stdin);
 }
 
 /** Imprime la ayuda del programa.
@@ -53,7 +60,12 @@ void load_from_stdin(DovahkiinP dova){
                         cambia al compilar. Encontrado en arv[0].
 */
 void print_help(char * programName){
-    printf("\n\nUSO: %s -s source -t sink [OPCIONES] < NETWORK\n\n", programName);
+    printf("\n\nUSO: %s -s source -t sink [OPCIONES] < NETWORK\n", programName);
+    printf("     %s -s source -t sink [OPCIONES] -i NETWORK\n", programName);
+    printf("     %s -s source -t sink [OPCIONES] --snapshot SNAPSHOT\n", 
+            programName);
+    printf("     %s -q QUERIES [OPCIONES] -i NETWORK\n", programName);
+    printf("     %s -g [-q QUERIES] [OPCIONES] -i NETWORK\n\n", programName);
     printf("OPCIONES:\n");
     printf("\t-s SOURCE \t\tConfigura al nodo SOURCE como fuente.\n");
     printf("\t-t SINK \t\tConfigura al nodo SINK como resumidero.\n");
@@ -65,7 +77,39 @@ void print_help(char * programName){
             "ignorando el tiempo\n\t\t\t\tde carga de datos. Usarlo sin otros "
             "parámetros de impresion para\n\t\t\t\tobtener el tiempo de calculo"
             " del algoritmo de Dinic. \n");
-    printf("\t-a --all \t\tEquivalente a -vf -f -p y -c.\n\n");
+    printf("\t-a --all \t\tEquivalente a -vf -f -p y -c.\n");
+    printf("\t-i --input FILE \tLee el network del archivo FILE en lugar de la "
+            "entrada\n\t\t\t\testándar. Si es un archivo regular se mapea en "
+            "memoria.\n");
+    printf("\t--snapshot FILE \tLee el network del snapshot FILE, escrito con "
+            "--save-snapshot.\n\t\t\t\tSe mapea en memoria sin parsear "
+            "los lados.\n");
+    printf("\t--save-snapshot FILE \tGuarda el network leído en el snapshot "
+            "FILE.\n");
+    printf("\t--dump-bin FILE \tEscribe en FILE el valor del flujo, el flujo de "
+            "cada lado\n\t\t\t\ty el corte en binario (u64 little-endian), "
+            "para\n\t\t\t\tleerlos desde otro programa. No se usa con -q "
+            "ni -g.\n");
+    printf("\t--dump-csv FILE \tIdem --dump-bin, pero en CSV.\n");
+    printf("\t-q --queries FILE \tResponde cada par 's t' de FILE (uno por "
+            "línea) sobre el\n\t\t\t\tnetwork cargado una sola vez, "
+            "anulando el flujo entre uno y\n\t\t\t\totro. Reemplaza a -s "
+            "y -t.\n");
+    printf("\t-g --gomory-hu \t\tImprime el árbol de Gomory-Hu del network "
+            "tomado como no\n\t\t\t\tdirigido, calculando a la vez tantos "
+            "flujos como hilos de -j.\n\t\t\t\tCon -q, en lugar del árbol "
+            "imprime la capacidad del corte\n\t\t\t\tminimal de cada par, "
+            "sacada del árbol. Reemplaza a -s y -t.\n");
+    printf("\t-e --engine MOTOR \tCalcula el flujo con MOTOR: dinic (por "
+            "defecto), o\n\t\t\t\tpush-relabel con hl (highest label) o "
+            "fifo. Con\n\t\t\t\tpar, push-relabel en paralelo con los hilos "
+            "de -j. Con\n\t\t\t\tpush-relabel no hay caminos aumentantes "
+            "que imprimir.\n");
+    printf("\t-P --poda \t\tPoda del network de niveles los nodos que no "
+            "llegan a t, para\n\t\t\t\tque el DFS no los recorra.\n");
+    printf("\t-j --hilos N \t\tArma los niveles de Dinic con un BFS por niveles "
+            "de N hilos,\n\t\t\t\tque pasa a ir de abajo hacia arriba "
+            "cuando la frontera es grande.\n\n");
     printf("\tNETWORK\t\t\tUna serie de elementos de la forma: x y c \\n, que "
             "representan el lado\n\t\t\t\tx->y de capacidad c.\n\n");
     printf("Ejemplo: $%s -f -vf -s 1 -t 0 < network.txt\n\n", programName);
@@ -76,6 +120,19 @@ void print_help(char * programName){
  * \param argv Vector de argumentos con los que se invoco al programa.
  * \param source Fuente del Network.
  * \param sink Resumidero del Network.
+ * \param input Archivo del que se lee el Network. Queda en NULL si se lee de
+ *              la entrada estándar. Es un snapshot si se activa SNAPSHOT.
+ * \param save Archivo en el que se guarda el snapshot del Network. Queda en
+ *              NULL si no se pasa --save-snapshot.
+ * \param queries Archivo con los pares (s,t) a responder. Queda en NULL si no
+ *              se pasa -q.
+ * \param dump Archivo en el que se vuelca el flujo. Queda en NULL si no se
+ *              pasa --dump-bin ni --dump-csv.
+ * \param dumpFormat Formato del volcado: VOLCADO_BIN o VOLCADO_CSV.
+ * \param threads Cantidad de hilos con los que se arman los niveles. Queda en
+ *              0 (el BFS de siempre) si no se pasa -j.
+ * \param engine Motor con el que se calcula el flujo. Queda en MOTOR_DINIC si
+ *              no se pasa --engine.
  * \return Retorna un Short int indicando el estado de los parámetros.\n
  * - Estados:\n
  *      - DONT_DINIC   Permite (o no) que se realice dinic.\n
@@ -86,13 +143,29 @@ void print_help(char * programName){
  *      - FLOW        Activa el muestreo de flujo.\n
  *      - CUT         Activa el muestreo de corte.\n
  *      - FLOW_V      Activa el muestre de valor del flujo.\n
+ *      - PRUNE       Activa la poda del network de niveles.\n
+ *      - SNAPSHOT    El network de entrada es un snapshot.\n
+ *      - QUERIES     Se responden los pares (s,t) de \p queries.\n
+ *      - GOMORY_HU   Se calcula el árbol de Gomory-Hu.\n
 */
-short int parametersChecker(int argc, char *argv[], u64 * source, u64 * sink){
+short int parametersChecker(int argc, char *argv[], u64 * source, u64 * sink,
+                            char ** input, char ** save,
+                            char ** queries, char ** dump,
+                            int * dumpFormat, unsigned int * threads,
+                            int * engine){
     int i = 1;                          /*Iterador para parámetros de entrada. 
                                         Saltea el nombre del programa.*/
     short int STATUS = CLEAR_FLAG();    /*Retorno de la función.*/
     short int HELP = 0;                 /*Se pide ayuda. Flag de alcance local*/
+    u64 j = 0;                          /*Cantidad de hilos leída de -j*/
     
+    *input = NULL;
+    *save = NULL;
+    *queries = NULL;
+    *dump = NULL;
+    *dumpFormat = VOLCADO_BIN;
+    *threads = 0;
+    *engine = MOTOR_DINIC;
     /*Valida cada uno de los parámetros de entrada en un loop que termina cuando
      * se pide imprimir la ayuda o cuando se leyeron todos los parámetros*/
     while (i < argc && !HELP){
@@ -135,6 +208,85 @@ short int parametersChecker(int argc, char *argv[], u64 * source, u64 * sink){
                 i++;
             }else
                 SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica el archivo del que se lee el network.*/
+        }else if((strcmp(argv[i], "-i") == 0 || strcmp(argv[i], "--input")== 0)
+                 && *input == NULL){
+            if (i+1 < argc){
+                *input = argv[i+1];
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica el snapshot del que se lee el network*/
+        }else if(strcmp(argv[i], "--snapshot") == 0 && *input == NULL){
+            if (i+1 < argc){
+                *input = argv[i+1];
+                SET_FLAG(SNAPSHOT);
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica dónde guardar el snapshot.*/
+        }else if(strcmp(argv[i], "--save-snapshot") == 0 && *save == NULL){
+            if (i+1 < argc){
+                *save = argv[i+1];
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica dónde volcar el flujo.*/
+        }else if((strcmp(argv[i], "--dump-bin") == 0 ||
+                  strcmp(argv[i], "--dump-csv") == 0) && *dump == NULL){
+            if (i+1 < argc){
+                *dump = argv[i+1];
+                if (strcmp(argv[i], "--dump-csv") == 0)
+                    *dumpFormat = VOLCADO_CSV;
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica el archivo de pares (s,t).*/
+        }else if((strcmp(argv[i], "-q") == 0 || strcmp(argv[i], "--queries")== 0)
+                 && *queries == NULL){
+            if (i+1 < argc){
+                *queries = argv[i+1];
+                SET_FLAG(QUERIES);
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica que se calcule el árbol de Gomory-Hu*/
+        }else if(strcmp(argv[i], "-g") == 0 || strcmp(argv[i], "--gomory-hu")== 0){
+            SET_FLAG(GOMORY_HU);
+        /*Se fija si el parámetro indica que se pode el network de niveles.*/
+        }else if(strcmp(argv[i], "-P") == 0 || strcmp(argv[i], "--poda")== 0){
+            SET_FLAG(PRUNE);
+        /*Se fija si el parámetro indica con que motor calcular el flujo.*/
+        }else if(strcmp(argv[i], "-e") == 0 || strcmp(argv[i], "--engine")== 0){
+            if (i+1 < argc){
+                if(strcmp(argv[i+1], "dinic") == 0)
+                    *engine = MOTOR_DINIC;
+                else if(strcmp(argv[i+1], "hl") == 0)
+                    *engine = MOTOR_HL;
+                else if(strcmp(argv[i+1], "fifo") == 0)
+                    *engine = MOTOR_FIFO;
+                else if(strcmp(argv[i+1], "par") == 0)
+                    *engine = MOTOR_PAR;
+                else{
+                    printf("%s: -e: Invalid argument \"%s\".\n", argv[0], argv[i+1]);
+                    SET_FLAG(DONT_DINIC);
+                }
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
+        /*Se fija si el parámetro indica con cuantos hilos trabajar.*/
+        }else if(strcmp(argv[i], "-j") == 0 || strcmp(argv[i], "--hilos")== 0){
+            if (i+1 < argc){
+                if(isu64(argv[i+1]) && sscanf(argv[i+1], "%" SCNu64, &j) == 1
+                   && j > 0 && j <= MAX_THREADS)
+                    *threads = (unsigned int) j;
+                else{
+                    printf("%s: -j: Invalid argument \"%s\".\n", argv[0], argv[i+1]);
+                    SET_FLAG(DONT_DINIC);
+                }
+                i++;
+            }else
+                SET_FLAG(DONT_DINIC);
         /*Este parámetro setea todos los demás parámetros, menos el de ayuda.*/
 
         }else if(strcmp(argv[i], "-a") == 0 || strcmp(argv[i], "--all")== 0 ){
@@ -159,16 +311,25 @@ short int parametersChecker(int argc, char *argv[], u64 * source, u64 * sink){
     }/*Finaliza el ciclo while.*/
    /*Imprime un mensaje de error porque no se seteó la fuente
    y configura que no se corra el algoritmo DINIC*/
-    if(!IS_SET_FLAG(S_OK) && !HELP){
+    if(!IS_SET_FLAG(S_OK) && !IS_SET_FLAG(QUERIES) &&
+       !IS_SET_FLAG(GOMORY_HU) && !HELP){
         printf("%s: -s is not set.\n", argv[0]);
         SET_FLAG(DONT_DINIC);
     }
    /*Imprime un mensaje de error porque no se seteó el resumidero
    y configura que no se corra el algoritmo DINIC*/
-    if(!IS_SET_FLAG(T_OK) && !HELP){
+    if(!IS_SET_FLAG(T_OK) && !IS_SET_FLAG(QUERIES) &&
+       !IS_SET_FLAG(GOMORY_HU) && !HELP){
         printf("%s: -t is not set.\n", argv[0]);
         SET_FLAG(DONT_DINIC);
     }
+   /*Imprime un mensaje de error porque el volcado es de un único flujo, y
+   configura que no se corra el algoritmo DINIC*/
+    if(*dump != NULL && (IS_SET_FLAG(QUERIES) || IS_SET_FLAG(GOMORY_HU))){
+        printf("%s: %s: Cannot be used with -q or -g.\n", argv[0],
+               *dumpFormat == VOLCADO_BIN ? "--dump-bin" : "--dump-csv");
+        SET_FLAG(DONT_DINIC);
+    }
     
     /*Si se pidio imprimir ayuda entonces se configura que no corra 
      *el algoritmo de DINIC*/
@@ -216,6 +377,120 @@ void print_dinicTime(float time){
     printf("\nDinic demoró(hh:mm:ss.ms): %02i:%02i:%02i.%03i\n\n", hs, min, sec, ms);
 }
 
+/** Calcula el flujo maximal entre la fuente y el resumidero fijados e imprime
+ * lo que se haya pedido.
+ * \param dova   El dova en el que se trabaja, con la fuente y el resumidero
+ *               fijados.
+ * \param STATUS Estado de los parámetros, devuelto por parametersChecker().
+ * \param engine Motor con el que se calcula el flujo.
+ * \return 1 si se pudo preparar el dova y se calculó el flujo.\n
+ *         0 caso contrario.
+ */
+int run_query(DovahkiinP dova, short int STATUS, int engine){
+    clock_t clock_startTime = 0; /*Registra el tiempo de inicio*/
+    clock_t clock_finishTime = 0; /*Registra el tiempo de finalización*/
+    float dinicTime = 0;    /*Resultado del tiempo*/
+    int result = 0;         /*Se calculó el flujo. Retorno*/
+    
+    if (Prepararse(dova) == 1){
+        result = 1;
+        if (IS_SET_FLAG(DINIC_TIME))
+            clock_startTime = clock();
+    
+        /*Los caminos solo se arman de a uno si hay que imprimirlos*/
+        if (IS_SET_FLAG(PATH) && engine == MOTOR_DINIC){
+            while (ActualizarDistancias(dova)){
+                while (BusquedaCaminoAumentante(dova))
+                    AumentarFlujoYTambienImprimirCamino(dova); 
+            }
+        }else
+            CalcularFlujoMaximal(dova);
+        /*Imprimo resultados de lo que se haya pedido*/
+        if (IS_SET_FLAG(FLOW))
+            ImprimirFlujo(dova);
+
+        if (IS_SET_FLAG(FLOW_V))
+            ImprimirValorFlujo(dova);
+        
+        if (IS_SET_FLAG(CUT))
+            ImprimirCorte(dova);
+    
+        if (IS_SET_FLAG(DINIC_TIME)){
+            clock_finishTime = clock();
+            dinicTime = (double)(clock_finishTime - clock_startTime) / CLOCKS_PER_SEC;
+            print_dinicTime(dinicTime);
+        }
+    }
+    return result;
+}
+
+/** Responde cada par (s,t) del archivo \p queries sobre el network ya
+ * cargado. Antes de cada par se anula el flujo del anterior con
+ * ResetearFlujo(), así que el network no se vuelve a cargar ni a congelar.
+ * Con GOMORY_HU, cada par se responde con el árbol de Gomory-Hu, que ya debe
+ * estar calculado, y solo se imprime la capacidad del corte.
+ * \param dova    El dova en el que se trabaja.
+ * \param STATUS  Estado de los parámetros, devuelto por parametersChecker().
+ * \param engine  Motor con el que se calcula el flujo.
+ * \param queries Archivo con un par 's t' por línea.
+ * \param programName Nombre del programa, para los mensajes de error.
+ */
+void run_queries(DovahkiinP dova, short int STATUS, int engine,
+                 char * queries, char * programName){
+    FILE *f = NULL;     /*Archivo de los pares*/
+    u64 s, t;           /*Fuente y resumidero del par actual*/
+    u64 k = 0;          /*Cantidad de pares respondidos*/
+    u64 cut;            /*Capacidad del corte, con GOMORY_HU*/
+    
+    f = fopen(queries, "r");
+    if (f == NULL)
+        printf("%s: -q: Cannot read \"%s\".\n", programName, queries);
+    else{
+        while (fscanf(f, "%" SCNu64 " %" SCNu64, &s, &t) == 2){
+            k++;
+            printf("Consulta %" PRIu64 ": s = %" PRIu64 ", t = %" PRIu64 "\n",
+                   k, s, t);
+            if (IS_SET_FLAG(GOMORY_HU)){
+                if (CorteMinimoEntre(dova, s, t, &cut))
+                    printf("Capacidad del corte minimal: %" PRIu64 "\n", cut);
+            }else{
+                ResetearFlujo(dova);
+                FijarFuente(dova, s);
+                FijarResumidero(dova, t);
+                run_query(dova, STATUS, engine);
+            }
+        }
+        if (!feof(f))
+            printf("%s: -q: Invalid pair in \"%s\".\n", programName, queries);
+        fclose(f);
+    }
+}
+
+/** Calcula el árbol de Gomory-Hu del network e imprime el árbol o, si se
+ * pasó \p queries, el corte minimal de cada par.
+ * \param dova    El dova en el que se trabaja.
+ * \param STATUS  Estado de los parámetros, devuelto por parametersChecker().
+ * \param queries Archivo con un par 's t' por línea, o NULL.
+ * \param programName Nombre del programa, para los mensajes de error.
+ */
+void run_gomoryHu(DovahkiinP dova, short int STATUS, char * queries,
+                  char * programName){
+    clock_t clock_startTime = 0; /*Registra el tiempo de inicio*/
+    float treeTime = 0;     /*Resultado del tiempo*/
+    
+    if (IS_SET_FLAG(DINIC_TIME))
+        clock_startTime = clock();
+    CalcularArbolGomoryHu(dova);
+    if (IS_SET_FLAG(DINIC_TIME))
+        treeTime = (double)(clock() - clock_startTime) / CLOCKS_PER_SEC;
+    if (queries == NULL)
+        ImprimirArbolGomoryHu(dova);
+    else
+        run_queries(dova, STATUS, MOTOR_DINIC, queries, programName);
+    if (IS_SET_FLAG(DINIC_TIME))
+        print_dinicTime(treeTime);
+}
+
 /** Algoritmo principal. 
  * Se encarga de llamar las funciones del API para implementar DINIC.
  * \param argc Cantidad de argumentos con los que se invoco el programa.
@@ -224,58 +499,62 @@ void print_dinicTime(float time){
  */
 int main(int argc, char *argv[]){
     DovahkiinP dova = NULL; /*El dovahkiin que voy a usar*/
-    u64 s = NULL;           /*El nombre del nodo que sera fuente*/
-    u64 t = NULL;           /*El nombre del nodo que sera resumidero*/
+    u64 s = 0;              /*El nombre del nodo que sera fuente*/
+    u64 t = 0;              /*El nombre del nodo que sera resumidero*/
     short int STATUS;       /*Estado de ejecución según el ingreso de parámetros*/
-    clock_t clock_startTime = 0; /*Registra el tiempo de inicio*/
-    clock_t clock_finishTime = 0; /*Registra el tiempo de finalización*/
-    float dinicTime = 0;    /*Resultado del tiempo*/
+    char *input = NULL;     /*Archivo del network. NULL si es la entrada estándar*/
+    char *save = NULL;      /*Archivo en el que se guarda el snapshot*/
+    char *queries = NULL;   /*Archivo con los pares (s,t) a responder*/
+    char *dump = NULL;      /*Archivo en el que se vuelca el flujo*/
+    int dumpFormat;         /*Formato del volcado*/
+    unsigned int threads;   /*Cantidad de hilos para los niveles*/
+    int engine;             /*Motor con el que se calcula el flujo*/
     
     /*Se controlan los parámetros de ingreso*/
-    STATUS = parametersChecker(argc, argv, &s, &t);
+    STATUS = parametersChecker(argc, argv, &s, &t, &input, &save, &queries,
+                               &dump, &dumpFormat, &threads, &engine);
 
     /* Se crea un nuevo dova y se cargan los valores del network*/
     dova = NuevoDovahkiin();
     assert(dova != NULL);
-    if(!IS_SET_FLAG(DONT_DINIC))
-        load_from_stdin(dova);
+    if(!IS_SET_FLAG(DONT_DINIC)){
+        if (input == NULL)
+            load_from_stdin(dova);
+        else if (IS_SET_FLAG(SNAPSHOT)){
+            if (!CargarSnapshot(dova, input))
+                printf("%s: --snapshot: Cannot read \"%s\".\n", argv[0], input);
+        }else if (!CargarDesdeRuta(dova, input))
+            printf("%s: -i: Cannot read \"%s\".\n", argv[0], input);
+        if (save != NULL && !GuardarSnapshot(dova, save))
+            printf("%s: --save-snapshot: Cannot write \"%s\".\n", argv[0], save);
+    }
     
     /*se calcula e imprime lo requerido*/
     FijarFuente(dova, s);
     FijarResumidero(dova, t);
+    if(!IS_SET_FLAG(DONT_DINIC) && threads > 0)
+        FijarHilos(dova, threads);
+    if(IS_SET_FLAG(PRUNE))
+        FijarPoda(dova, 1);
+    FijarMotor(dova, engine);
     
 //  Funciones no utilizadas en nuestro main. Quedan para testeo de la API.
 //  ImprimirFuente(dova);
 //  ImprimirResumidero(dova);
 
-    if (Prepararse(dova) == 1){
-        if (IS_SET_FLAG(DINIC_TIME))
-            clock_startTime = clock();
-        
-        while (ActualizarDistancias(dova)){
-            while (BusquedaCaminoAumentante(dova)){
-                if (IS_SET_FLAG(PATH)){
-                    AumentarFlujoYTambienImprimirCamino(dova); 
-                }else{
-                    AumentarFlujo(dova); 
-                }  
-            }
-        }
-        /*Imprimo resultados de lo que se haya pedido*/
-        if (IS_SET_FLAG(FLOW))
-            ImprimirFlujo(dova);
-
-        if (IS_SET_FLAG(FLOW_V))
-            ImprimirValorFlujo(dova);
-            
-        if (IS_SET_FLAG(CUT))
-            ImprimirCorte(dova);
-        
-        if (IS_SET_FLAG(DINIC_TIME)){
-            clock_finishTime = clock();
-            dinicTime = (double)(clock_finishTime - clock_startTime) / CLOCKS_PER_SEC;
-            print_dinicTime(dinicTime);
-        }
+    if (IS_SET_FLAG(GOMORY_HU)){
+        if (!IS_SET_FLAG(DONT_DINIC))
+            run_gomoryHu(dova, STATUS, queries, argv[0]);
+    }else if (IS_SET_FLAG(QUERIES)){
+        if (!IS_SET_FLAG(DONT_DINIC))
+            run_queries(dova, STATUS, engine, queries, argv[0]);
+    }else{
+        /*Solo se vuelca si se llegó a calcular el flujo*/
+        if (run_query(dova, STATUS, engine) && dump != NULL &&
+            !IS_SET_FLAG(DONT_DINIC) && !VolcarFlujo(dova, dump, dumpFormat))
+            printf("%s: %s: Cannot write \"%s\".\n", argv[0],
+                   dumpFormat == VOLCADO_BIN ? "--dump-bin" : "--dump-csv",
+                   dump);
     }
     /* destruyo el dova*/
     if (!DestruirDovahkiin(dova))